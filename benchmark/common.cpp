@@ -0,0 +1,47 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Stand-ins for the ipmid symbols Handler links against, so the benchmarks
+// run without libipmid.
+
+#include <user_channel/channel_layer.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace ipmi
+{
+std::uint8_t getChannelByName(const std::string& chName)
+{
+    return chName.size() + 10;
+}
+
+// Channel 1 is the only LAN channel.
+bool isValidChannel(const std::uint8_t chNum)
+{
+    return chNum == 1;
+}
+
+Cc getChannelInfo(const std::uint8_t, ChannelInfo& chInfo)
+{
+    chInfo = {};
+    chInfo.mediumType = static_cast<std::uint8_t>(EChannelMediumType::lan8032);
+    return ccSuccess;
+}
+
+std::string getChannelName(const std::uint8_t chNum)
+{
+    return chNum == 1 ? "eth0" : "";
+}
+} // namespace ipmi
@@ -0,0 +1,127 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Entity name lookups: the JSON walk in readNameFromConfig against the flat
+// EntityNameIndex, over a generated map with every supported entity type.
+//
+// Every benchmark takes one argument:
+//   instances - records per entity type in the generated map.
+
+#include "entity_index.hpp"
+#include "handler_impl.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace google
+{
+namespace ipmi
+{
+namespace
+{
+
+nlohmann::json makeConfig(int instances)
+{
+    nlohmann::json config = nlohmann::json::object();
+    for (const auto& [id, type] : entityTypes)
+    {
+        auto& readings = config[std::string(type)];
+        for (int i = 0; i < instances; ++i)
+        {
+            readings.push_back(
+                {{"instance", i},
+                 {"name", std::format("/{}/{}_{}", type, type, i)}});
+        }
+    }
+    return config;
+}
+
+// A fixed mix of hits and misses (one in four asks past the last instance),
+// so both paths see the same key sequence.
+std::vector<std::pair<std::uint8_t, std::uint8_t>> makeQueries(int instances)
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<size_t> type(0, entityTypes.size() - 1);
+    std::uniform_int_distribution<int> instance(0, instances * 4 / 3);
+
+    std::vector<std::pair<std::uint8_t, std::uint8_t>> queries(1024);
+    for (auto& q : queries)
+    {
+        q = {entityTypes[type(rng)].first,
+             static_cast<std::uint8_t>(std::min(instance(rng), 255))};
+    }
+    return queries;
+}
+
+void BM_ReadNameFromConfig(benchmark::State& state)
+{
+    auto config = makeConfig(state.range(0));
+    auto queries = makeQueries(state.range(0));
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto& [id, instance] = queries[i++ % queries.size()];
+        std::string type(*entityTypeName(id));
+        benchmark::DoNotOptimize(readNameFromConfig(type, instance, config));
+    }
+}
+
+void BM_EntityNameIndexFind(benchmark::State& state)
+{
+    EntityNameIndex index(makeConfig(state.range(0)));
+    auto queries = makeQueries(state.range(0));
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto& [id, instance] = queries[i++ % queries.size()];
+        benchmark::DoNotOptimize(index.find(id, instance));
+    }
+}
+
+void BM_EntityNameIndexBuild(benchmark::State& state)
+{
+    auto config = makeConfig(state.range(0));
+
+    for (auto _ : state)
+    {
+        EntityNameIndex index(config);
+        benchmark::DoNotOptimize(index.size());
+    }
+}
+
+void instanceArgs(benchmark::internal::Benchmark* b)
+{
+    b->RangeMultiplier(4)->Range(4, 256)->ArgName("instances");
+}
+
+BENCHMARK(BM_ReadNameFromConfig)->Apply(instanceArgs);
+BENCHMARK(BM_EntityNameIndexFind)->Apply(instanceArgs);
+BENCHMARK(BM_EntityNameIndexBuild)->Apply(instanceArgs);
+
+} // namespace
+} // namespace ipmi
+} // namespace google
+
+BENCHMARK_MAIN();
@@ -0,0 +1,474 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// End-to-end latency of the Handler paths that talk to other services.
+//
+// A private dbus-daemon is started for the lifetime of the binary and both
+// DBUS_SYSTEM_BUS_ADDRESS and DBUS_SESSION_BUS_ADDRESS are pointed at it, so
+// the real Handler connects to it without any injection. A single connection
+// on a helper thread then owns the well known names Handler talks to and
+// serves them with configurable latency and failure injection.
+//
+// Every benchmark takes two arguments:
+//   latency_us    - delay added by the stand-in before replying.
+//   fail_permille - fraction (in 1/1000) of calls failed with EIO.
+
+#include "errors.hpp"
+#include "handler.hpp"
+#include "handler_impl.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <ipmid/message.hpp>
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/asio/object_server.hpp>
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/exception.hpp>
+#include <stdplus/print.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace google
+{
+namespace ipmi
+{
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Runs dbus-daemon in the foreground and points the default buses at it.
+class PrivateBus
+{
+  public:
+    PrivateBus()
+    {
+        const char* daemon = std::getenv("DBUS_DAEMON");
+        if (daemon == nullptr)
+        {
+            daemon = "dbus-daemon";
+        }
+
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0)
+        {
+            throw std::runtime_error("pipe2 failed");
+        }
+
+        pid = fork();
+        if (pid < 0)
+        {
+            throw std::runtime_error("fork failed");
+        }
+        if (pid == 0)
+        {
+            dup2(fds[1], STDOUT_FILENO);
+            execlp(daemon, daemon, "--session", "--nofork", "--print-address",
+                   nullptr);
+            _exit(127);
+        }
+        close(fds[1]);
+
+        std::string address;
+        char c;
+        while (read(fds[0], &c, 1) == 1 && c != '\n')
+        {
+            address.push_back(c);
+        }
+        close(fds[0]);
+
+        if (address.empty())
+        {
+            stop();
+            throw std::runtime_error("dbus-daemon did not report an address");
+        }
+
+        setenv("DBUS_SYSTEM_BUS_ADDRESS", address.c_str(), 1);
+        setenv("DBUS_SESSION_BUS_ADDRESS", address.c_str(), 1);
+    }
+
+    ~PrivateBus()
+    {
+        stop();
+    }
+
+    PrivateBus(const PrivateBus&) = delete;
+    PrivateBus& operator=(const PrivateBus&) = delete;
+
+  private:
+    void stop()
+    {
+        if (pid > 0)
+        {
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+            pid = -1;
+        }
+    }
+
+    pid_t pid = -1;
+};
+
+struct StandInConfig
+{
+    std::atomic<uint32_t> latencyUs{0};
+    std::atomic<uint32_t> failurePermille{0};
+};
+
+// Stand-ins for com.google.custom_accel, systemd, ExternalSensor and
+// AccelPower, serving only the objects Handler touches.
+class StandInServices
+{
+  public:
+    explicit StandInServices(StandInConfig& config) : config(config)
+    {
+        std::promise<void> ready;
+        auto started = ready.get_future();
+        thread = std::thread([this, &ready] { run(ready); });
+        started.get();
+    }
+
+    ~StandInServices()
+    {
+        io.stop();
+        thread.join();
+    }
+
+    StandInServices(const StandInServices&) = delete;
+    StandInServices& operator=(const StandInServices&) = delete;
+
+  private:
+    void inject()
+    {
+        if (uint32_t us = config.latencyUs.load())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        }
+        uint32_t permille = config.failurePermille.load();
+        if (permille != 0 && rng() % 1000 < permille)
+        {
+            throw sdbusplus::exception::SdBusError(EIO, "injected failure");
+        }
+    }
+
+    void run(std::promise<void>& ready)
+    {
+        bool started = false;
+        try
+        {
+            auto conn = std::make_shared<sdbusplus::asio::connection>(io);
+            sdbusplus::asio::object_server server(conn);
+
+            auto manager = server.add_manager("/");
+            auto accel = server.add_interface("/com/google/customAccel/bench0",
+                                              "com.google.custom_accel.BAR");
+            accel->register_method(
+                "Read", [this](uint64_t address, uint64_t numBytes) {
+                    inject();
+                    return std::vector<uint8_t>(numBytes,
+                                                static_cast<uint8_t>(address));
+                });
+            accel->register_method(
+                "Write", [this](uint64_t, std::vector<uint8_t>) { inject(); });
+            accel->initialize();
+
+            auto systemd =
+                server.add_interface("/org/freedesktop/systemd1",
+                                     "org.freedesktop.systemd1.Manager");
+            systemd->register_method(
+                "StartUnit", [this](const std::string&, const std::string&) {
+                    inject();
+                    return sdbusplus::message::object_path(
+                        "/org/freedesktop/systemd1/job/1");
+                });
+            systemd->initialize();
+
+            auto sensor = server.add_interface(
+                "/xyz/openbmc_project/sensors/power/idle_mode_0",
+                "xyz.openbmc_project.Sensor.Value");
+            sensor->register_property_r<double>(
+                "Value", sdbusplus::vtable::property_::none,
+                [this](const double&) {
+                    inject();
+                    return 120.0;
+                });
+            sensor->initialize();
+
+            auto power =
+                server.add_interface("/com/google/accelPower/accel_power_0",
+                                     "com.google.accelPower.Mode");
+            power->register_property_rw<int>(
+                "PowerMode", sdbusplus::vtable::property_::none,
+                [this](const int& req, int& value) {
+                    inject();
+                    value = req;
+                    return true;
+                },
+                [](const int& value) { return value; });
+            power->initialize();
+
+            conn->request_name("com.google.custom_accel");
+            conn->request_name("org.freedesktop.systemd1");
+            conn->request_name("xyz.openbmc_project.ExternalSensor");
+            conn->request_name("com.google.AccelPower");
+
+            ready.set_value();
+            started = true;
+            io.run();
+        }
+        catch (...)
+        {
+            if (started)
+            {
+                throw;
+            }
+            ready.set_exception(std::current_exception());
+        }
+    }
+
+    StandInConfig& config;
+    std::minstd_rand rng;
+    boost::asio::io_context io;
+    std::thread thread;
+};
+
+StandInConfig standInConfig;
+
+class LatencyRecorder
+{
+  public:
+    void add(Clock::duration d)
+    {
+        samples.push_back(
+            std::chrono::duration<double, std::micro>(d).count());
+    }
+
+    void report(benchmark::State& state)
+    {
+        if (samples.empty())
+        {
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto at = [this](double q) {
+            return samples[static_cast<size_t>(q * (samples.size() - 1))];
+        };
+        state.counters["p50_us"] = at(0.50);
+        state.counters["p99_us"] = at(0.99);
+        state.counters["p999_us"] = at(0.999);
+        state.counters["max_us"] = samples.back();
+    }
+
+  private:
+    std::vector<double> samples;
+};
+
+template <typename Fn>
+void runCommand(benchmark::State& state, Fn&& fn)
+{
+    standInConfig.latencyUs = state.range(0);
+    standInConfig.failurePermille = state.range(1);
+
+    LatencyRecorder latency;
+    int64_t errors = 0;
+    for (auto _ : state)
+    {
+        auto start = Clock::now();
+        try
+        {
+            if constexpr (std::is_void_v<std::invoke_result_t<Fn&>>)
+            {
+                fn();
+            }
+            else if (!fn())
+            {
+                ++errors;
+            }
+        }
+        catch (const IpmiException&)
+        {
+            ++errors;
+        }
+        latency.add(Clock::now() - start);
+    }
+
+    latency.report(state);
+    state.counters["errors"] = errors;
+}
+
+// The VR settings paths need an ipmid context with a live yield context, so
+// the timed loop runs inside a coroutine on a private client connection.
+template <typename Fn>
+void runYieldCommand(benchmark::State& state, Fn&& fn)
+{
+    boost::asio::io_context io;
+    auto bus = std::make_shared<sdbusplus::asio::connection>(
+        io, sdbusplus::bus::new_bus().release());
+
+    boost::asio::spawn(
+        io,
+        [&](boost::asio::yield_context yield) {
+            auto ctx = std::make_shared<::ipmi::Context>(
+                bus, ::ipmi::netFnOemGroup, 0, 0x32, 0, 0, 0,
+                ::ipmi::Privilege::User, 0, 0, yield);
+            runCommand(state, [&] { return fn(ctx); });
+        },
+        boost::asio::detached);
+    io.run();
+}
+
+// The power paths drop their delay files before calling systemd; keep them
+// out of the real /run so a benchmark never changes a live delay.
+class TempRunHandler : public Handler
+{
+  public:
+    TempRunHandler()
+    {
+        char tmpl[] = "/tmp/handler_benchmarkXXXXXX";
+        if (::mkdtemp(tmpl) == nullptr)
+        {
+            throw std::runtime_error("mkdtemp failed");
+        }
+        runDir = tmpl;
+    }
+
+    ~TempRunHandler() override
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(runDir, ec);
+    }
+
+  protected:
+    fs::path getRunDir() const override
+    {
+        return runDir;
+    }
+
+  private:
+    fs::path runDir;
+};
+
+void BM_AccelOobDeviceCount(benchmark::State& state)
+{
+    Handler h;
+    runCommand(state, [&] { return h.accelOobDeviceCount(); });
+}
+
+void BM_AccelOobRead(benchmark::State& state)
+{
+    Handler h;
+    runCommand(state, [&] { return h.accelOobRead("bench0", 0x40, 4); });
+}
+
+void BM_AccelOobWrite(benchmark::State& state)
+{
+    Handler h;
+    runCommand(state,
+               [&] { return h.accelOobWrite("bench0", 0x40, 4, 0x12345678); });
+}
+
+void BM_AccelGetVrSettings(benchmark::State& state)
+{
+    Handler h;
+    runYieldCommand(state, [&](::ipmi::Context::ptr ctx) {
+        return h.accelGetVrSettings(ctx, 0, 0);
+    });
+}
+
+void BM_AccelSetVrSettings(benchmark::State& state)
+{
+    Handler h;
+    runYieldCommand(state, [&](::ipmi::Context::ptr ctx) {
+        return h.accelSetVrSettings(ctx, 0, 0, 1);
+    });
+}
+
+void BM_HostPowerOffDelay(benchmark::State& state)
+{
+    TempRunHandler h;
+    runCommand(state, [&] { h.hostPowerOffDelay(0); });
+}
+
+void BM_PsuResetDelay(benchmark::State& state)
+{
+    TempRunHandler h;
+    runCommand(state, [&] { h.psuResetDelay(0); });
+}
+
+void standInArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgsProduct({{0, 100, 1000}, {0, 10}})
+        ->ArgNames({"latency_us", "fail_permille"})
+        ->UseRealTime();
+}
+
+BENCHMARK(BM_AccelOobDeviceCount)->Apply(standInArgs);
+BENCHMARK(BM_AccelOobRead)->Apply(standInArgs);
+BENCHMARK(BM_AccelOobWrite)->Apply(standInArgs);
+BENCHMARK(BM_AccelGetVrSettings)->Apply(standInArgs);
+BENCHMARK(BM_AccelSetVrSettings)->Apply(standInArgs);
+BENCHMARK(BM_HostPowerOffDelay)->Apply(standInArgs);
+BENCHMARK(BM_PsuResetDelay)->Apply(standInArgs);
+
+} // namespace
+} // namespace ipmi
+} // namespace google
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    try
+    {
+        google::ipmi::PrivateBus bus;
+        google::ipmi::StandInServices standIns(google::ipmi::standInConfig);
+        benchmark::RunSpecifiedBenchmarks();
+    }
+    catch (const std::exception& e)
+    {
+        stdplus::print(stderr, "Benchmark setup failed: {}\n", e.what());
+        return 1;
+    }
+
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// PCIe slot map scans over a synthetic sysfs and device tree: the previous
+// std::filesystem/std::regex/ifstream walk against buildPcieMap().
+//
+// Every benchmark takes one argument:
+//   buses - i2c-N entries in the fixture; one in four has a PCIe slot and
+//           each bus also has one client device entry next to it.
+
+#include "util.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace google
+{
+namespace ipmi
+{
+namespace
+{
+
+namespace fs = std::filesystem;
+
+class Fixture
+{
+  public:
+    explicit Fixture(int buses)
+    {
+        char tmpl[] = "/tmp/pcie_map_benchmarkXXXXXX";
+        root = ::mkdtemp(tmpl);
+        devices = root + "/devices";
+        deviceTree = root + "/dt";
+
+        for (int bus = 0; bus < buses; ++bus)
+        {
+            fs::create_directories(std::format("{}/i2c-{}", devices, bus));
+            fs::create_directories(std::format("{}/{}-0050", devices, bus));
+            if (bus % 4 != 0)
+            {
+                continue;
+            }
+
+            auto node = std::format("/ahb/i2c-mux/pcie-slot@{}", bus);
+            fs::create_directories(
+                std::format("{}/i2c-{}/of_node", devices, bus));
+            write(std::format("{}/i2c-{}/of_node/pcie-slot", devices, bus),
+                  node + '\0');
+            fs::create_directories(deviceTree + node);
+            write(std::format("{}{}/label", deviceTree, node),
+                  std::format("PE{}", bus) + '\0');
+        }
+    }
+
+    ~Fixture()
+    {
+        fs::remove_all(root);
+    }
+
+    std::string root;
+    std::string devices;
+    std::string deviceTree;
+
+  private:
+    static void write(const std::string& path, const std::string& data)
+    {
+        std::ofstream(path, std::ios::binary) << data;
+    }
+};
+
+// The scan buildPcieMap() replaced, kept here as the baseline.
+std::string legacyReadPropertyFile(const std::string& fileName)
+{
+    std::ifstream ifs(fileName);
+    std::string contents;
+    if (ifs.is_open() && ifs >> contents)
+    {
+        if (!contents.empty() && contents.back() == '\0')
+        {
+            contents.pop_back();
+        }
+        return contents;
+    }
+    return "";
+}
+
+std::vector<std::tuple<std::uint32_t, std::string>> legacyBuildPcieMap(
+    const std::string& devices, const std::string& deviceTree)
+{
+    std::vector<std::tuple<std::uint32_t, std::string>> map;
+    for (const auto& dev : fs::directory_iterator(devices))
+    {
+        std::string path = dev.path();
+        std::smatch match;
+        std::regex e("(i2c-)(\\d+)");
+        if (!std::regex_search(path, match, e))
+        {
+            continue;
+        }
+        std::string slot = legacyReadPropertyFile(path + "/of_node/pcie-slot");
+        if (slot.empty())
+        {
+            continue;
+        }
+        std::string name = legacyReadPropertyFile(deviceTree + slot + "/label");
+        if (name.empty())
+        {
+            continue;
+        }
+        map.emplace_back(std::stoi(match[2]), name);
+    }
+    return map;
+}
+
+void BM_LegacyBuildPcieMap(benchmark::State& state)
+{
+    Fixture fixture(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            legacyBuildPcieMap(fixture.devices, fixture.deviceTree));
+    }
+}
+
+void BM_BuildPcieMap(benchmark::State& state)
+{
+    Fixture fixture(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            buildPcieMap(fixture.devices, fixture.deviceTree));
+    }
+}
+
+void busArgs(benchmark::internal::Benchmark* b)
+{
+    b->Arg(50)->Arg(500)->ArgName("buses")->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_LegacyBuildPcieMap)->Apply(busArgs);
+BENCHMARK(BM_BuildPcieMap)->Apply(busArgs);
+
+} // namespace
+} // namespace ipmi
+} // namespace google
+
+BENCHMARK_MAIN();
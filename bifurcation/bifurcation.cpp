@@ -0,0 +1,35 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "config.h"
+
+#include "bifurcation.hpp"
+
+#include <functional>
+
+namespace google
+{
+namespace ipmi
+{
+
+std::reference_wrapper<BifurcationInterface> createBifurcation()
+{
+#if DYNAMIC_BIFURCATION
+    return BifurcationDynamic::createBifurcation();
+#else
+    return BifurcationStatic::createBifurcation();
+#endif
+}
+
+} // namespace ipmi
+} // namespace google
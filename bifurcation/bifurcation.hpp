@@ -13,12 +13,17 @@
 // limitations under the License.
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace google
@@ -32,13 +37,27 @@ class BifurcationInterface
     virtual ~BifurcationInterface() = default;
 
     /**
-     * Get the Bifurcation of the device at the i2c bus
+     * Get the bifurcation of a PCIe slot
      *
-     * @param[in] bus    - I2C bus of the device
-     * @return the bifurcation at the i2c bus
+     * @param[in] index  - index of the slot
+     * @return the bifurcation of the slot
      */
     virtual std::optional<std::vector<uint8_t>> getBifurcation(
-        uint8_t bus) noexcept = 0;
+        uint8_t index) noexcept = 0;
+
+    /**
+     * Get the bifurcation of every configured slot
+     *
+     * @return (index, lanes) for each slot, in index order
+     */
+    virtual std::vector<std::tuple<uint8_t, std::vector<uint8_t>>>
+        getBifurcations() noexcept = 0;
+
+    /**
+     * Note that the PCIe or I2C topology may have changed, as on a uevent.
+     * May be called from any thread.
+     */
+    virtual void invalidate() noexcept {}
 };
 
 class BifurcationStatic : public BifurcationInterface
@@ -53,15 +72,120 @@ class BifurcationStatic : public BifurcationInterface
 
     BifurcationStatic(std::string_view bifurcationFile);
 
+    /**
+     * Get the bifurcation of a slot from the parsed table. The file is only
+     * parsed again once its modification time, size or inode changes.
+     */
     std::optional<std::vector<uint8_t>> getBifurcation(
         uint8_t index) noexcept override;
 
+    std::vector<std::tuple<uint8_t, std::vector<uint8_t>>>
+        getBifurcations() noexcept override;
+
   protected:
     BifurcationStatic();
 
   private:
+    /** Identifies the version of the file the table was parsed from. */
+    struct FileStamp
+    {
+        uint64_t inode;
+        int64_t size;
+        int64_t mtimeSec;
+        int64_t mtimeNsec;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    /** Parse the file again if it changed since the table was built. */
+    void refresh() noexcept;
+    void parse() noexcept;
+
     std::string bifurcationFile;
+    std::optional<FileStamp> stamp;
+    // Whether the file was missing at the last refresh, so it is only
+    // reported once.
+    bool missing = false;
+    std::array<std::optional<std::vector<uint8_t>>, 256> table;
+};
+
+/**
+ * Derives the bifurcation of each PCIe slot from the live topology. Slots are
+ * found through the i2c buses and indexed in i2c bus order, so lookups are by
+ * slot index as with the static file, which serves the slots that cannot be
+ * derived.
+ *
+ * The slot is the device tree node named by the bus's of_node/pcie-slot
+ * property. Each child node of the slot is one port, in unit address order,
+ * and the slot itself is the only port when it has none. A port's width is its
+ * num-lanes property, or else the max_link_width of the PCI device whose
+ * of_node is the port.
+ *
+ * The table is kept until invalidate(). While a slot has no width, as while
+ * sysfs is still being populated or when the slot is empty, the slots that
+ * did resolve are served and a lookup scans again once a delay has passed,
+ * doubling up to maxRetryDelay. Each unresolved port is logged once.
+ */
+class BifurcationDynamic : public BifurcationInterface
+{
+  public:
+    static std::reference_wrapper<BifurcationInterface> createBifurcation()
+    {
+        static BifurcationDynamic bifurcationDynamic;
+
+        return std::ref(bifurcationDynamic);
+    }
+
+    static constexpr std::chrono::milliseconds maxRetryDelay =
+        std::chrono::minutes(1);
+
+    /**
+     * @param[in] sysfsDir - the sysfs mount, holding bus/i2c and bus/pci.
+     * @param[in] deviceTreeDir - the device tree, as /proc/device-tree.
+     * @param[in] bifurcationFile - the static fallback file.
+     * @param[in] retryDelay - the first delay before an unresolved scan is
+     *                         tried again.
+     */
+    BifurcationDynamic(
+        std::string_view sysfsDir, std::string_view deviceTreeDir,
+        std::string_view bifurcationFile,
+        std::chrono::milliseconds retryDelay = std::chrono::seconds(1));
+
+    std::optional<std::vector<uint8_t>> getBifurcation(
+        uint8_t index) noexcept override;
+
+    std::vector<std::tuple<uint8_t, std::vector<uint8_t>>>
+        getBifurcations() noexcept override;
+
+    void invalidate() noexcept override;
+
+  protected:
+    BifurcationDynamic();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /** Derive the table again if it was invalidated or a retry is due. */
+    void build() noexcept;
+    /** Scan the topology into the table; false if a slot did not resolve. */
+    bool scan();
+
+    std::string sysfsDir;
+    std::string deviceTreeDir;
+    BifurcationStatic fallback;
+    std::chrono::milliseconds firstRetryDelay;
+    std::chrono::milliseconds retryDelay;
+    // When to scan again, if the last scan did not resolve every slot.
+    std::optional<Clock::time_point> retryAt;
+    // Set by invalidate(), on any thread.
+    std::atomic<bool> stale = true;
+    std::array<std::optional<std::vector<uint8_t>>, 256> table;
+    // The "slot/port" of each port already logged as unresolved.
+    std::unordered_set<std::string> reported;
 };
 
+/** The backend selected at build time by the bifurcation option. */
+std::reference_wrapper<BifurcationInterface> createBifurcation();
+
 } // namespace ipmi
 } // namespace google
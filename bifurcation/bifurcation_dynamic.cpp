@@ -0,0 +1,336 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "config.h"
+
+#include "bifurcation.hpp"
+
+#include <stdplus/print.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace
+{
+
+namespace fs = std::filesystem;
+
+// Where sysfs of_node links point; /proc/device-tree is a link to it.
+constexpr std::string_view deviceTreeBase = "/devicetree/base";
+
+std::optional<std::string> readFile(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+template <typename T>
+std::optional<T> parseNumber(std::string_view str, int base = 10)
+{
+    T value;
+    auto [ptr, ec] =
+        std::from_chars(str.data(), str.data() + str.size(), value, base);
+    if (ec != std::errc() || ptr != str.data() + str.size())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// A device tree string property, without its NUL terminator.
+std::optional<std::string> readString(const fs::path& path)
+{
+    auto value = readFile(path);
+    if (!value || value->empty())
+    {
+        return std::nullopt;
+    }
+    value->erase(value->find_last_not_of('\0') + 1);
+    return value;
+}
+
+// A single big-endian device tree cell, as num-lanes is stored.
+std::optional<uint32_t> readCell(const fs::path& path)
+{
+    auto value = readFile(path);
+    if (!value || value->size() != sizeof(uint32_t))
+    {
+        return std::nullopt;
+    }
+    uint32_t cell = 0;
+    for (unsigned char c : *value)
+    {
+        cell = cell << 8 | c;
+    }
+    return cell;
+}
+
+// A decimal sysfs attribute such as max_link_width.
+std::optional<uint32_t> readAttribute(const fs::path& path)
+{
+    auto value = readFile(path);
+    if (!value)
+    {
+        return std::nullopt;
+    }
+    value->erase(value->find_last_not_of(" \n") + 1);
+    return parseNumber<uint32_t>(*value);
+}
+
+// Maps device tree node paths, as "/ahb/pcie@1e7d0000/port@0", to the PCI
+// device bound to them.
+std::unordered_map<std::string, fs::path> pciDevicesByNode(
+    const fs::path& pciDevicesDir)
+{
+    std::unordered_map<std::string, fs::path> devices;
+    std::error_code ec;
+    for (const auto& dev : fs::directory_iterator(pciDevicesDir, ec))
+    {
+        std::string target = fs::read_symlink(dev.path() / "of_node", ec);
+        auto pos = target.find(deviceTreeBase);
+        if (ec || pos == std::string::npos)
+        {
+            continue;
+        }
+        devices.try_emplace(target.substr(pos + deviceTreeBase.size()),
+                            dev.path());
+    }
+    return devices;
+}
+
+// Sort key for a device tree child node: its unit address, then its name.
+std::tuple<uint64_t, std::string> portOrder(const std::string& name)
+{
+    auto at = name.find('@');
+    std::optional<uint64_t> address;
+    if (at != std::string::npos)
+    {
+        address = parseNumber<uint64_t>(
+            std::string_view(name).substr(at + 1, name.find(',', at) - at - 1),
+            16);
+    }
+    return {address.value_or(UINT64_MAX), name};
+}
+
+} // namespace
+
+BifurcationDynamic::BifurcationDynamic() :
+    BifurcationDynamic("/sys", "/proc/device-tree", STATIC_BIFURCATION_CONFIG)
+{}
+
+BifurcationDynamic::BifurcationDynamic(std::string_view sysfsDir,
+                                       std::string_view deviceTreeDir,
+                                       std::string_view bifurcationFile,
+                                       std::chrono::milliseconds retryDelay) :
+    sysfsDir(sysfsDir), deviceTreeDir(deviceTreeDir), fallback(bifurcationFile),
+    firstRetryDelay(retryDelay), retryDelay(retryDelay)
+{}
+
+std::optional<std::vector<uint8_t>> BifurcationDynamic::getBifurcation(
+    uint8_t index) noexcept
+{
+    build();
+    if (table[index])
+    {
+        return table[index];
+    }
+    return fallback.getBifurcation(index);
+}
+
+std::vector<std::tuple<uint8_t, std::vector<uint8_t>>>
+    BifurcationDynamic::getBifurcations() noexcept
+{
+    build();
+
+    // Both are in index order; a derived slot overrides the static one.
+    auto fallbackSlots = fallback.getBifurcations();
+    auto next = fallbackSlots.begin();
+    std::vector<std::tuple<uint8_t, std::vector<uint8_t>>> slots;
+    for (size_t index = 0; index < table.size(); ++index)
+    {
+        bool fromFallback = next != fallbackSlots.end() &&
+                            std::get<0>(*next) == index;
+        if (table[index])
+        {
+            slots.emplace_back(index, *table[index]);
+        }
+        else if (fromFallback)
+        {
+            slots.push_back(std::move(*next));
+        }
+        if (fromFallback)
+        {
+            ++next;
+        }
+    }
+    return slots;
+}
+
+void BifurcationDynamic::invalidate() noexcept
+{
+    stale = true;
+}
+
+void BifurcationDynamic::build() noexcept
+{
+    if (stale.exchange(false))
+    {
+        retryDelay = firstRetryDelay;
+    }
+    else if (!retryAt || Clock::now() < *retryAt)
+    {
+        return;
+    }
+
+    bool resolved = false;
+    try
+    {
+        resolved = scan();
+    }
+    catch (const std::exception& e)
+    {
+        stdplus::print(stderr, "Failed to derive bifurcation: {}\n",
+                       e.what());
+    }
+
+    // A slot without a width, or no slot at all, may only mean sysfs or the
+    // device tree is not fully populated yet; look again later.
+    if (resolved)
+    {
+        retryAt.reset();
+    }
+    else
+    {
+        retryAt = Clock::now() + retryDelay;
+        retryDelay = std::min(retryDelay * 2, maxRetryDelay);
+    }
+}
+
+bool BifurcationDynamic::scan()
+{
+    std::array<std::optional<std::vector<uint8_t>>, 256> lanesByIndex;
+    bool derived = false;
+    bool unresolved = false;
+    fs::path sysfs(sysfsDir);
+    auto pciDevices = pciDevicesByNode(sysfs / "bus/pci/devices");
+
+    auto portWidth = [&](const std::string& node) {
+        auto lanes = readCell(deviceTreeDir + node + "/num-lanes");
+        if (!lanes)
+        {
+            if (auto dev = pciDevices.find(node); dev != pciDevices.end())
+            {
+                lanes = readAttribute(dev->second / "max_link_width");
+            }
+        }
+        std::optional<uint8_t> width;
+        if (lanes && *lanes > 0 && *lanes <= UINT8_MAX)
+        {
+            width = *lanes;
+        }
+        return width;
+    };
+
+    // The slot on each i2c bus; slots are indexed in bus order.
+    std::map<uint8_t, std::string> slotsByBus;
+    std::error_code ec;
+    for (const auto& dev :
+         fs::directory_iterator(sysfs / "bus/i2c/devices", ec))
+    {
+        auto name = dev.path().filename().native();
+        if (!name.starts_with("i2c-"))
+        {
+            continue;
+        }
+        auto bus = parseNumber<uint8_t>(std::string_view(name).substr(4));
+        auto slot = readString(dev.path() / "of_node/pcie-slot");
+        if (bus && slot)
+        {
+            slotsByBus.emplace(*bus, std::move(*slot));
+        }
+    }
+
+    size_t index = 0;
+    for (const auto& [bus, slot] : slotsByBus)
+    {
+        std::vector<std::string> ports;
+        for (const auto& child :
+             fs::directory_iterator(deviceTreeDir + slot, ec))
+        {
+            if (child.is_directory(ec))
+            {
+                ports.push_back(child.path().filename());
+            }
+        }
+        std::ranges::sort(ports, {}, portOrder);
+
+        std::vector<uint8_t> lanes;
+        if (ports.empty())
+        {
+            ports.emplace_back();
+        }
+        for (const auto& port : ports)
+        {
+            auto width = portWidth(port.empty() ? slot : slot + "/" + port);
+            if (!width)
+            {
+                if (reported.insert(slot + "/" + port).second)
+                {
+                    stdplus::print(stderr,
+                                   "No lane width for {}/{}, i2c bus {}, "
+                                   "slot {}\n",
+                                   slot, port, bus, index);
+                }
+                lanes.clear();
+                unresolved = true;
+                break;
+            }
+            lanes.push_back(*width);
+        }
+        if (!lanes.empty())
+        {
+            lanesByIndex[index] = std::move(lanes);
+            derived = true;
+        }
+        ++index;
+    }
+
+    table = std::move(lanesByIndex);
+    return derived && !unresolved;
+}
+
+} // namespace ipmi
+} // namespace google
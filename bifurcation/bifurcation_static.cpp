@@ -15,14 +15,20 @@
 
 #include "bifurcation.hpp"
 
+#include <sys/stat.h>
+
 #include <nlohmann/json.hpp>
 #include <stdplus/print.hpp>
 
 #include <charconv>
-#include <filesystem>
+#include <cstdint>
+#include <exception>
 #include <fstream>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <tuple>
 #include <vector>
 
 namespace google
@@ -41,6 +47,60 @@ BifurcationStatic::BifurcationStatic(std::string_view bifurcationFile) :
 std::optional<std::vector<uint8_t>> BifurcationStatic::getBifurcation(
     uint8_t index) noexcept
 {
+    refresh();
+    return table[index];
+}
+
+std::vector<std::tuple<uint8_t, std::vector<uint8_t>>>
+    BifurcationStatic::getBifurcations() noexcept
+{
+    refresh();
+    std::vector<std::tuple<uint8_t, std::vector<uint8_t>>> slots;
+    for (size_t index = 0; index < table.size(); ++index)
+    {
+        if (table[index])
+        {
+            slots.emplace_back(index, *table[index]);
+        }
+    }
+    return slots;
+}
+
+void BifurcationStatic::refresh() noexcept
+{
+    struct stat st;
+    if (::stat(bifurcationFile.c_str(), &st) < 0)
+    {
+        // Most platforms have no file, so only say so when it goes missing.
+        if (!missing)
+        {
+            stdplus::print(stderr,
+                           "Unable to open file {} for bifurcation.\n",
+                           bifurcationFile.data());
+            missing = true;
+        }
+        stamp.reset();
+        table = {};
+        return;
+    }
+    missing = false;
+
+    FileStamp current{static_cast<uint64_t>(st.st_ino),
+                      static_cast<int64_t>(st.st_size),
+                      static_cast<int64_t>(st.st_mtim.tv_sec),
+                      static_cast<int64_t>(st.st_mtim.tv_nsec)};
+    if (stamp == current)
+    {
+        return;
+    }
+    stamp = current;
+    parse();
+}
+
+void BifurcationStatic::parse() noexcept
+{
+    table = {};
+
     // Example valid data:
     // {
     //     "1": [8,8],
@@ -51,7 +111,7 @@ std::optional<std::vector<uint8_t>> BifurcationStatic::getBifurcation(
     {
         stdplus::print(stderr, "Unable to open file {} for bifurcation.\n",
                        bifurcationFile.data());
-        return std::nullopt;
+        return;
     }
 
     nlohmann::json jsonData;
@@ -65,24 +125,38 @@ std::optional<std::vector<uint8_t>> BifurcationStatic::getBifurcation(
             stderr,
             "Failed to parse the static config. Parse error at byte {}\n",
             ex.byte);
-        return std::nullopt;
+        return;
     }
-
-    std::vector<uint8_t> vec;
-    try
+    if (!jsonData.is_object())
     {
-        std::string key = std::to_string(index);
-        auto value = jsonData[key];
-        value.get_to(vec);
+        stdplus::print(stderr, "Static bifurcation config is not an object\n");
+        return;
     }
-    catch (const std::exception& e)
+
+    for (const auto& [key, value] : jsonData.items())
     {
-        stdplus::print(stderr,
-                       "Failed to convert bifurcation value to vec[uin8_t]\n");
-        return std::nullopt;
-    }
+        // Keys are slot indexes in decimal, as std::to_string() spells them.
+        uint8_t index;
+        auto [ptr, ec] = std::from_chars(key.data(), key.data() + key.size(),
+                                         index);
+        if (ec != std::errc() || ptr != key.data() + key.size() ||
+            (key.size() > 1 && key.front() == '0'))
+        {
+            stdplus::print(stderr, "Invalid bifurcation slot index {}\n", key);
+            continue;
+        }
 
-    return vec;
+        try
+        {
+            table[index] = value.get<std::vector<uint8_t>>();
+        }
+        catch (const std::exception& e)
+        {
+            stdplus::print(
+                stderr,
+                "Failed to convert bifurcation value to vec[uin8_t]\n");
+        }
+    }
 }
 
 } // namespace ipmi
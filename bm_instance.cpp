@@ -17,11 +17,18 @@
 #include "commands.hpp"
 #include "errors.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
+
+#include <endian.h>
 
 #include <ipmid/api-types.hpp>
 #include <stdplus/print.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <span>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -51,8 +58,12 @@ Resp getBMInstanceProperty(std::span<const uint8_t> data,
         return ::ipmi::responseReqDataLenInvalid();
     }
 
-    std::string bmInstanceProperty =
-        handler->getBMInstanceProperty(/*type=*/data[0]);
+    auto property = handler->getBMInstanceProperty(/*type=*/data[0]);
+    if (!property)
+    {
+        return ::ipmi::response(property.error());
+    }
+    const std::string& bmInstanceProperty = *property;
 
     const size_t length =
         sizeof(struct BMInstancePropertyReply) + bmInstanceProperty.size();
@@ -72,5 +83,52 @@ Resp getBMInstanceProperty(std::span<const uint8_t> data,
     return ::ipmi::responseSuccess(SysOEMCommands::SysGetBMInstanceProperty,
                                    reply);
 }
+
+Resp getBMInstanceProperties(std::span<const uint8_t> data,
+                             HandlerInterface* handler)
+{
+    struct BMInstancePropertiesRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n",
+                       static_cast<uint32_t>(data.size()));
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+    size_t offset = le16toh(request.offset);
+
+    std::vector<std::uint8_t> fields;
+    for (const auto& [propertyType, property] :
+         handler->getBMInstanceProperties(/*refresh=*/offset == 0))
+    {
+        if (property.size() > UINT8_MAX)
+        {
+            stdplus::print(stderr, "Skipping property {}, too long\n",
+                           propertyType);
+            continue;
+        }
+        fields.emplace_back(propertyType);
+        fields.emplace_back(property.size());
+        fields.insert(fields.end(), property.begin(), property.end());
+    }
+    if (offset > 0 && offset >= fields.size())
+    {
+        return ::ipmi::responseParmOutOfRange();
+    }
+
+    // The fields are split across pages by byte, not by record.
+    using Page = PagedReply<struct BMInstancePropertiesReply>;
+    Page page;
+    size_t length = std::min(fields.size() - offset, Page::maxRecordLength);
+    if (page.full(fields.size() - offset))
+    {
+        page.header.nextOffset = htole16(offset + length);
+    }
+    page.add(std::span<const std::uint8_t>(fields).subspan(offset, length));
+    return ::ipmi::responseSuccess(SysOEMCommands::SysGetBMInstanceProperties,
+                                   std::move(page).bytes());
+}
 } // namespace ipmi
 } // namespace google
@@ -31,5 +31,30 @@ struct BMInstancePropertyReply
 Resp getBMInstanceProperty(std::span<const uint8_t> data,
                            HandlerInterface* handler);
 
+struct BMInstancePropertiesRequest
+{
+    // Little endian.
+    uint16_t offset;
+} __attribute__((packed));
+
+struct BMInstancePropertiesReply
+{
+    uint8_t more;
+    // Little endian.
+    uint16_t nextOffset;
+} __attribute__((packed));
+
+// Each field of the properties, back to back, followed by the property string.
+struct BMInstancePropertiesField
+{
+    uint8_t bmInstancePropertyType;
+    uint8_t bmInstancePropertyLength;
+} __attribute__((packed));
+
+// Return every BM instance property as fields, as many bytes of them as fit
+// in a reply, from an offset. Offset 0 takes the current properties.
+Resp getBMInstanceProperties(std::span<const uint8_t> data,
+                             HandlerInterface* handler);
+
 } // namespace ipmi
 } // namespace google
@@ -19,7 +19,13 @@
 #include "handler.hpp"
 
 #include <ipmid/api-types.hpp>
+#include <stdplus/print.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <span>
 #include <vector>
 
@@ -41,5 +47,33 @@ Resp getBmcMode(std::span<const uint8_t>, HandlerInterface* handler)
         return ::ipmi::response(e.getIpmiError());
     }
 }
+
+Resp waitBmcModeChange(::ipmi::Context::ptr ctx, std::span<const uint8_t> data,
+                       HandlerInterface* handler)
+{
+    struct WaitBmcModeChangeRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+    auto timeout = std::min<std::chrono::seconds>(
+        std::chrono::seconds(request.timeoutSeconds), maxBmcModeWait);
+
+    try
+    {
+        return ::ipmi::responseSuccess(
+            SysOEMCommands::SysWaitBmcModeChange,
+            std::vector<std::uint8_t>{
+                handler->waitBmcModeChange(ctx, request.lastMode, timeout)});
+    }
+    catch (const IpmiException& e)
+    {
+        return ::ipmi::response(e.getIpmiError());
+    }
+}
 } // namespace ipmi
 } // namespace google
@@ -20,6 +20,7 @@
 
 #include <ipmid/api-types.hpp>
 
+#include <chrono>
 #include <span>
 
 namespace google
@@ -29,5 +30,21 @@ namespace ipmi
 
 Resp getBmcMode(std::span<const uint8_t> data, HandlerInterface* handler);
 
+struct WaitBmcModeChangeRequest
+{
+    uint8_t lastMode;
+    uint8_t timeoutSeconds;
+} __attribute__((packed));
+
+// The longest a request is held, whatever timeout it asks for. The Linux KCS
+// and BT drivers give up on a request after about 5 seconds, so stay below
+// that.
+constexpr std::chrono::seconds maxBmcModeWait(4);
+
+// Reply with the BMC mode once it differs from the one the host last saw, or
+// the timeout passes, holding the request in the meantime.
+Resp waitBmcModeChange(::ipmi::Context::ptr ctx, std::span<const uint8_t> data,
+                       HandlerInterface* handler);
+
 } // namespace ipmi
 } // namespace google
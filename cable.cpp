@@ -17,14 +17,20 @@
 #include "commands.hpp"
 #include "errors.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
+
+#include <endian.h>
+#include <linux/if.h>
 
 #include <ipmid/api-types.hpp>
 #include <stdplus/print.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -77,23 +83,78 @@ Resp cableCheck(std::span<const uint8_t> data, const HandlerInterface* handler)
     // Copy the string out of the request buffer.
     std::memcpy(&nameBuf[0], request + 1, request->ifNameLength);
     std::string name = nameBuf;
-    int64_t count;
-
-    try
-    {
-        count = handler->getRxPackets(name);
-    }
-    catch (const IpmiException& e)
+    auto count = handler->getRxPackets(name);
+    if (!count)
     {
-        return ::ipmi::response(e.getIpmiError());
+        return ::ipmi::response(count.error());
     }
 
     // If we have received packets then there is a cable present.
-    std::uint8_t value = (count > 0) ? 1 : 0;
+    std::uint8_t value = (*count > 0) ? 1 : 0;
 
     return ::ipmi::responseSuccess(SysOEMCommands::SysCableCheck,
                                    std::vector<std::uint8_t>{value});
 }
 
+Resp cableCheckAll(std::span<const uint8_t> data, HandlerInterface* handler)
+{
+    struct CableCheckAllRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+
+    auto statuses = handler->getLinkStatuses(/*refresh=*/request.entry == 0);
+    if (!statuses)
+    {
+        return ::ipmi::response(statuses.error());
+    }
+    if (request.entry > 0 && request.entry >= statuses->size())
+    {
+        return ::ipmi::responseParmOutOfRange();
+    }
+
+    auto saturate = [](std::uint64_t value) {
+        return htole32(static_cast<std::uint32_t>(
+            std::min<std::uint64_t>(value, UINT32_MAX)));
+    };
+
+    PagedReply<struct CableCheckAllReply> page;
+    for (size_t entry = request.entry; entry < statuses->size(); ++entry)
+    {
+        const auto& [link, rxDelta, txDelta] = (*statuses)[entry];
+        if (page.full(sizeof(struct CableCheckAllRecord) + link.name.size()))
+        {
+            page.header.nextEntry = entry;
+            break;
+        }
+
+        struct CableCheckAllRecord record = {};
+        if (link.operState == IF_OPER_UP)
+        {
+            record.flags |= cableLinkUp;
+        }
+        if (link.flags & IFF_LOWER_UP)
+        {
+            record.flags |= cableCarrier;
+        }
+        if (rxDelta > 0)
+        {
+            record.flags |= cablePacketsReceived;
+        }
+        record.rxDelta = saturate(rxDelta);
+        record.txDelta = saturate(txDelta);
+        record.ifNameLength = link.name.size();
+        page.add(record, link.name);
+    }
+
+    return ::ipmi::responseSuccess(SysOEMCommands::SysCableCheckAll,
+                                   std::move(page).bytes());
+}
+
 } // namespace ipmi
 } // namespace google
@@ -37,5 +37,43 @@ struct CableReply
 // interested in.
 Resp cableCheck(std::span<const uint8_t> data, const HandlerInterface* handler);
 
+struct CableCheckAllRequest
+{
+    uint8_t entry;
+} __attribute__((packed));
+
+struct CableCheckAllReply
+{
+    uint8_t more;
+    uint8_t nextEntry;
+    uint8_t recordCount;
+} __attribute__((packed));
+
+// Bits of CableCheckAllRecord::flags.
+enum CableCheckAllFlags : uint8_t
+{
+    // The interface is operationally up.
+    cableLinkUp = 1 << 0,
+    // The interface has a carrier.
+    cableCarrier = 1 << 1,
+    // The interface received packets since the previous query, which is what
+    // SysCableCheck reports.
+    cablePacketsReceived = 1 << 2,
+};
+
+struct CableCheckAllRecord
+{
+    uint8_t flags;
+    // Little endian, saturating.
+    uint32_t rxDelta;
+    uint32_t txDelta;
+    uint8_t ifNameLength;
+} __attribute__((packed));
+
+// Handle the check of every interface at once. Sys can read as many
+// interfaces as fit in a reply, starting at an entry; entry 0 takes a new
+// dump and the counter deltas are since the previous entry 0.
+Resp cableCheckAll(std::span<const uint8_t> data, HandlerInterface* handler);
+
 } // namespace ipmi
 } // namespace google
@@ -0,0 +1,198 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cached_file_reader.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace
+{
+
+constexpr std::string_view whitespace = " \t\n\r\f\v";
+
+// Errors from reading an open file that mean the file it was opened as is
+// gone, so the path should be opened again.
+bool isReplaced(int err)
+{
+    return err == ENOENT || err == ESTALE || err == ENODEV;
+}
+
+} // namespace
+
+CachedFileReader::CachedFileReader(size_t maxFiles,
+                                   std::chrono::milliseconds recheck) :
+    maxFiles(maxFiles), recheck(recheck)
+{}
+
+std::expected<int, int> CachedFileReader::open(const std::string& path,
+                                               bool verify) const
+{
+    auto now = std::chrono::steady_clock::now();
+    auto it = files.find(path);
+    if (it != files.end())
+    {
+        it->second.used = ++uses;
+        if (!verify && now - it->second.checked < recheck)
+        {
+            return it->second.fd.get();
+        }
+    }
+
+    struct stat st;
+    if (::stat(path.c_str(), &st) < 0)
+    {
+        int err = errno;
+        drop(path);
+        return std::unexpected(err);
+    }
+
+    if (it != files.end())
+    {
+        if (it->second.dev == st.st_dev && it->second.ino == st.st_ino)
+        {
+            it->second.checked = now;
+            return it->second.fd.get();
+        }
+        files.erase(it);
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return std::unexpected(errno);
+    }
+
+    if (files.size() >= maxFiles)
+    {
+        files.erase(std::ranges::min_element(
+            files, {}, [](const auto& entry) { return entry.second.used; }));
+    }
+    files.emplace(path, File{ScopedFd(fd), st.st_dev, st.st_ino, now, ++uses});
+    return fd;
+}
+
+void CachedFileReader::drop(const std::string& path) const
+{
+    files.erase(path);
+}
+
+std::expected<size_t, int> CachedFileReader::read(const std::string& path,
+                                                  std::span<char> buf) const
+{
+    std::lock_guard guard(lock);
+
+    // One retry, checking the path first: an empty or failed read may be of
+    // a file that was replaced or removed since it was opened.
+    for (int attempt = 0;; ++attempt)
+    {
+        auto fd = open(path, attempt > 0);
+        if (!fd)
+        {
+            return std::unexpected(fd.error());
+        }
+
+        ssize_t len = ::pread(*fd, buf.data(), buf.size(), 0);
+        if (len > 0 || (len == 0 && attempt > 0))
+        {
+            return len;
+        }
+        if (len == 0)
+        {
+            continue;
+        }
+
+        int err = errno;
+        drop(path);
+        if (attempt > 0 || !isReplaced(err))
+        {
+            return std::unexpected(err);
+        }
+    }
+}
+
+std::expected<std::string, int> CachedFileReader::readAll(
+    const std::string& path) const
+{
+    std::lock_guard guard(lock);
+
+    for (int attempt = 0;; ++attempt)
+    {
+        auto fd = open(path, attempt > 0);
+        if (!fd)
+        {
+            return std::unexpected(fd.error());
+        }
+
+        std::string contents;
+        std::array<char, 4096> buf;
+        ssize_t len;
+        while ((len = ::pread(*fd, buf.data(), buf.size(), contents.size())) >
+               0)
+        {
+            contents.append(buf.data(), len);
+        }
+        if (len == 0 && (!contents.empty() || attempt > 0))
+        {
+            return contents;
+        }
+        if (len == 0)
+        {
+            continue;
+        }
+
+        int err = errno;
+        drop(path);
+        if (attempt > 0 || !isReplaced(err))
+        {
+            return std::unexpected(err);
+        }
+    }
+}
+
+std::string_view firstToken(std::string_view data)
+{
+    auto start = data.find_first_not_of(whitespace);
+    if (start == std::string_view::npos)
+    {
+        return {};
+    }
+    data.remove_prefix(start);
+    return data.substr(0, data.find_first_of(whitespace));
+}
+
+std::string_view firstLine(std::string_view data)
+{
+    return data.substr(0, data.find('\n'));
+}
+
+} // namespace ipmi
+} // namespace google
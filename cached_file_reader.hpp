@@ -0,0 +1,139 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "scoped_fd.hpp"
+
+#include <sys/types.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+namespace google
+{
+namespace ipmi
+{
+
+/** Reads files the handler polls; mocked by the tests. */
+class FileReaderInterface
+{
+  public:
+    virtual ~FileReaderInterface() = default;
+
+    /**
+     * Read the start of a file.
+     *
+     * @param[in] path - the file to read.
+     * @param[out] buf - where to read to; at most buf.size() bytes are read.
+     * @return the number of bytes read, or the errno of the failure.
+     */
+    virtual std::expected<size_t, int> read(const std::string& path,
+                                            std::span<char> buf) const = 0;
+
+    /**
+     * Read a whole file, of any size.
+     *
+     * @param[in] path - the file to read.
+     * @return the contents, or the errno of the failure.
+     */
+    virtual std::expected<std::string, int> readAll(
+        const std::string& path) const = 0;
+};
+
+/**
+ * Reads small sysfs, procfs and /run files that are read over and over.
+ *
+ * Files stay open after the first read and are read again from the start with
+ * pread(). The path is stat()ed again at most once per recheck interval, and
+ * straight away after a read that fails or comes back empty, so a file
+ * replaced by renaming over it, or removed, is reopened or reported missing
+ * rather than read stale past that. Past the limit of open files, the one
+ * read least recently is closed.
+ */
+class CachedFileReader : public FileReaderInterface
+{
+  public:
+    /**
+     * @param[in] maxFiles - how many files to keep open at once.
+     * @param[in] recheck - how long an open file is read without checking
+     *                      that its path still names it.
+     */
+    explicit CachedFileReader(
+        size_t maxFiles = 32,
+        std::chrono::milliseconds recheck = std::chrono::seconds(1));
+
+    CachedFileReader(const CachedFileReader&) = delete;
+    CachedFileReader& operator=(const CachedFileReader&) = delete;
+
+    std::expected<size_t, int> read(const std::string& path,
+                                    std::span<char> buf) const override;
+    std::expected<std::string, int> readAll(
+        const std::string& path) const override;
+
+  private:
+    struct File
+    {
+        ScopedFd fd;
+        dev_t dev;
+        ino_t ino;
+        // When the path was last seen to name this file.
+        std::chrono::steady_clock::time_point checked;
+        // The use count as of the last read, for eviction.
+        uint64_t used;
+    };
+
+    std::expected<int, int> open(const std::string& path, bool verify) const;
+    void drop(const std::string& path) const;
+
+    size_t maxFiles;
+    std::chrono::milliseconds recheck;
+    mutable std::mutex lock;
+    mutable std::unordered_map<std::string, File> files;
+    mutable uint64_t uses = 0;
+};
+
+/** The first whitespace separated token of data, as `istream >> string`. */
+std::string_view firstToken(std::string_view data);
+
+/** The first line of data, without its newline. */
+std::string_view firstLine(std::string_view data);
+
+/** Parse the first token of data as a decimal integer. */
+template <typename T>
+std::optional<T> parseInteger(std::string_view data)
+{
+    auto token = firstToken(data);
+    T value;
+    auto [ptr, ec] =
+        std::from_chars(token.data(), token.data() + token.size(), value);
+    if (ec != std::errc() || ptr != token.data() + token.size())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+} // namespace ipmi
+} // namespace google
@@ -75,6 +75,30 @@ enum SysOEMCommands
     SysWriteBiosSetting = 25,
     // Get Core Count
     SysGetCoreCount = 30,
+    // List the "entity id:entity instance" to entity name mappings, paged.
+    SysEntityNameList = 31,
+    // List the pcie slot to i2c bus mappings, paged.
+    SysPcieSlotI2cBusMappingList = 32,
+    // Find the pcie slot with a name.
+    SysPcieSlotByName = 33,
+    // Find the pcie slot on an i2c bus.
+    SysPcieSlotByBus = 34,
+    // List the bifurcation of every pcie slot, paged.
+    SysPCIeSlotBifurcationList = 35,
+    // Wait for the BMC mode to change.
+    SysWaitBmcModeChange = 36,
+    // Check the cables of every interface, paged.
+    SysCableCheckAll = 37,
+    // Get every ethernet device and its IPMI channel, paged.
+    SysGetEthDevices = 38,
+    // Get the version of every cpld, paged.
+    SysCpldVersions = 39,
+    // Get the partition table of the bmc flash, paged.
+    SysMtdPartitions = 40,
+    // Get the SHA-256 of a whole MTD device, hashed in the background.
+    SysFlashFullDigest = 41,
+    // Get every BM instance property at once, fragmented.
+    SysGetBMInstanceProperties = 42,
 };
 
 } // namespace ipmi
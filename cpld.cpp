@@ -17,12 +17,20 @@
 #include "commands.hpp"
 #include "errors.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
 
 #include <ipmid/api-types.hpp>
 #include <stdplus/print.hpp>
 
+#include <array>
+#include <charconv>
+#include <cstdint>
 #include <cstring>
+#include <optional>
 #include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -30,6 +38,42 @@ namespace google
 namespace ipmi
 {
 
+std::optional<VersionTuple> parseVersion(std::string_view value)
+{
+    std::array<std::uint8_t, 4> fields{};
+    const char* pos = value.data();
+    const char* end = value.data() + value.size();
+    size_t count = 0;
+    for (; count < fields.size(); ++count)
+    {
+        if (count > 0)
+        {
+            if (pos == end || *pos != '.')
+            {
+                break;
+            }
+            ++pos;
+        }
+        int field;
+        auto [next, ec] = std::from_chars(pos, end, field);
+        if (ec == std::errc::result_out_of_range)
+        {
+            return std::nullopt;
+        }
+        if (ec != std::errc())
+        {
+            break;
+        }
+        fields[count] = static_cast<std::uint8_t>(field);
+        pos = next;
+    }
+    if (count == 0)
+    {
+        return std::nullopt;
+    }
+    return std::make_tuple(fields[0], fields[1], fields[2], fields[3]);
+}
+
 struct CpldRequest
 {
     uint8_t id;
@@ -38,7 +82,7 @@ struct CpldRequest
 //
 // Handle reading the cpld version from the tmpfs.
 //
-Resp cpldVersion(std::span<const uint8_t> data, const HandlerInterface* handler)
+Resp cpldVersion(std::span<const uint8_t> data, HandlerInterface* handler)
 {
     struct CpldRequest request;
 
@@ -56,25 +100,58 @@ Resp cpldVersion(std::span<const uint8_t> data, const HandlerInterface* handler)
     // letter, because it does that.
     std::memcpy(&request, data.data(), sizeof(request));
 
-    try
+    auto values =
+        handler->getCpldVersion(static_cast<unsigned int>(request.id));
+    if (!values)
     {
-        auto values =
-            handler->getCpldVersion(static_cast<unsigned int>(request.id));
-
-        // Truncate if the version is too high (documented).
-        auto major = std::get<0>(values);
-        auto minor = std::get<1>(values);
-        auto point = std::get<2>(values);
-        auto subpoint = std::get<3>(values);
-
-        return ::ipmi::responseSuccess(
-            SysOEMCommands::SysCpldVersion,
-            std::vector<std::uint8_t>{major, minor, point, subpoint});
+        return ::ipmi::response(values.error());
     }
-    catch (const IpmiException& e)
+
+    // Truncate if the version is too high (documented).
+    auto major = std::get<0>(*values);
+    auto minor = std::get<1>(*values);
+    auto point = std::get<2>(*values);
+    auto subpoint = std::get<3>(*values);
+
+    return ::ipmi::responseSuccess(
+        SysOEMCommands::SysCpldVersion,
+        std::vector<std::uint8_t>{major, minor, point, subpoint});
+}
+
+Resp cpldVersions(std::span<const uint8_t> data, HandlerInterface* handler)
+{
+    struct CpldVersionsRequest request;
+
+    if (data.size() < sizeof(request))
     {
-        return ::ipmi::response(e.getIpmiError());
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
     }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+
+    PagedReply<struct CpldVersionsReply> page;
+    for (const auto& [id, version] : handler->getCpldVersions())
+    {
+        if (id < request.id)
+        {
+            continue;
+        }
+        if (page.full(sizeof(struct CpldVersionsRecord)))
+        {
+            page.header.nextId = id;
+            break;
+        }
+
+        struct CpldVersionsRecord record = {};
+        record.id = id;
+        std::tie(record.version.major, record.version.minor,
+                 record.version.point, record.version.subpoint) = version;
+        page.add(record);
+    }
+
+    return ::ipmi::responseSuccess(SysOEMCommands::SysCpldVersions,
+                                   std::move(page).bytes());
 }
 
 } // namespace ipmi
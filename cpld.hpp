@@ -20,7 +20,9 @@
 
 #include <ipmid/api-types.hpp>
 
+#include <optional>
 #include <span>
+#include <string_view>
 
 namespace google
 {
@@ -35,9 +37,33 @@ struct CpldReply
     uint8_t subpoint;
 } __attribute__((packed));
 
+// Parse "a.b.c.d", or its first few fields, as a version. A field that does
+// not fit in a byte is truncated to one, as documented for SysCpldVersion.
+std::optional<VersionTuple> parseVersion(std::string_view value);
+
 // Given a cpld identifier, return a version if available.
-Resp cpldVersion(std::span<const uint8_t> data,
-                 const HandlerInterface* handler);
+Resp cpldVersion(std::span<const uint8_t> data, HandlerInterface* handler);
+
+struct CpldVersionsRequest
+{
+    uint8_t id;
+} __attribute__((packed));
+
+struct CpldVersionsReply
+{
+    uint8_t more;
+    uint8_t nextId;
+    uint8_t recordCount;
+} __attribute__((packed));
+
+struct CpldVersionsRecord
+{
+    uint8_t id;
+    struct CpldReply version;
+} __attribute__((packed));
+
+// Return the version of every cpld, from an id on, as many as fit in a reply.
+Resp cpldVersions(std::span<const uint8_t> data, HandlerInterface* handler);
 
 } // namespace ipmi
 } // namespace google
@@ -0,0 +1,182 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "entity_index.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace
+{
+
+constexpr std::uint16_t makeKey(std::uint8_t id, std::uint8_t instance)
+{
+    return static_cast<std::uint16_t>(id << 8 | instance);
+}
+
+} // namespace
+
+std::optional<std::string_view> entityTypeName(std::uint8_t id)
+{
+    auto it = std::lower_bound(
+        entityTypes.begin(), entityTypes.end(), id,
+        [](const auto& type, std::uint8_t value) {
+            return type.first < value;
+        });
+    if (it == entityTypes.end() || it->first != id)
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+EntityNameIndex::EntityNameIndex(const nlohmann::json& config)
+{
+    if (!config.is_object())
+    {
+        return;
+    }
+
+    // Types are visited in ID order and instances in file order, so a stable
+    // sort by key leaves the first record for each instance in front.
+    std::vector<std::pair<std::uint16_t, std::string_view>> records;
+    for (const auto& [id, type] : entityTypes)
+    {
+        auto readings = config.find(type);
+        if (readings == config.end() || !readings->is_array())
+        {
+            continue;
+        }
+
+        for (const auto& j : *readings)
+        {
+            if (!j.is_object())
+            {
+                continue;
+            }
+
+            // Same truncation as readNameFromConfig's uint8_t conversion.
+            std::uint8_t instanceNum = 0;
+            if (auto instance = j.find("instance"); instance != j.end())
+            {
+                if (!instance->is_number_integer())
+                {
+                    continue;
+                }
+                instanceNum = static_cast<std::uint8_t>(instance->get<int>());
+            }
+
+            std::string_view name;
+            if (auto it = j.find("name"); it != j.end() && it->is_string())
+            {
+                name = it->get_ref<const std::string&>();
+            }
+            records.emplace_back(makeKey(id, instanceNum), name);
+        }
+    }
+
+    assign(records);
+}
+
+EntityNameIndex::EntityNameIndex(std::span<const Record> records)
+{
+    std::vector<std::pair<std::uint16_t, std::string_view>> keyed;
+    keyed.reserve(records.size());
+    for (const auto& record : records)
+    {
+        // Unlike the JSON map, an unnamed record carries no meaning here.
+        if (!record.name.empty())
+        {
+            keyed.emplace_back(makeKey(record.id, record.instance),
+                               record.name);
+        }
+    }
+
+    assign(keyed);
+}
+
+void EntityNameIndex::assign(
+    std::vector<std::pair<std::uint16_t, std::string_view>>& records)
+{
+    std::stable_sort(
+        records.begin(), records.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t total = 0;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        auto& name = records[i].second;
+        if ((i > 0 && records[i].first == records[i - 1].first) ||
+            name.size() > std::numeric_limits<std::uint16_t>::max())
+        {
+            name = {};
+        }
+        total += name.size();
+    }
+
+    ownedNames.reserve(total);
+    for (const auto& [key, name] : records)
+    {
+        if (!name.empty())
+        {
+            ownedEntries.push_back(
+                Entry{key, static_cast<std::uint16_t>(name.size()),
+                      static_cast<std::uint32_t>(ownedNames.size())});
+            ownedNames.append(name);
+        }
+    }
+    ownedEntries.shrink_to_fit();
+
+    entries = ownedEntries;
+    names = ownedNames;
+}
+
+std::span<const EntityNameIndex::Entry> EntityNameIndex::from(
+    std::uint8_t id, std::uint8_t instance) const
+{
+    auto it = std::lower_bound(
+        entries.begin(), entries.end(), makeKey(id, instance),
+        [](const Entry& entry, std::uint16_t value) {
+            return entry.key < value;
+        });
+    return std::span(it, entries.end());
+}
+
+std::optional<std::string_view> EntityNameIndex::find(
+    std::uint8_t id, std::uint8_t instance) const
+{
+    auto rest = from(id, instance);
+    if (rest.empty() || rest.front().key != makeKey(id, instance))
+    {
+        return std::nullopt;
+    }
+    return name(rest.front());
+}
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,187 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * The IPMI entity IDs served by SysEntityName, sorted by ID, and the key each
+ * one is listed under in the entity association map.
+ */
+inline constexpr std::array<std::pair<std::uint8_t, std::string_view>, 13>
+    entityTypes{{
+        {0x03, "cpu"},
+        {0x04, "storage_device"},
+        {0x06, "system_management_module"},
+        {0x07, "system_board"},
+        {0x08, "memory_module"},
+        {0x0B, "add_in_card"},
+        {0x0E, "power_system_board"},
+        {0x10, "system_internal_expansion_board"},
+        {0x11, "other_system_board"},
+        {0x17, "system_chassis"},
+        {0x1D, "fan"},
+        {0x1E, "cooling_unit"},
+        {0x20, "memory_device"},
+    }};
+
+/**
+ * Return the entity association map key for an entity ID.
+ *
+ * @param[in] id - the entity id value
+ * @return the key, or std::nullopt if the ID is not supported.
+ */
+std::optional<std::string_view> entityTypeName(std::uint8_t id);
+
+/**
+ * A flat (entity id, entity instance) -> name table built once from the
+ * entity association map.
+ *
+ * Entries are sorted by (id, instance) and point into a single string holding
+ * every name, so a lookup is a binary search over 8-byte records and never
+ * allocates. The table is either built at runtime from parsed JSON or is a
+ * view of one generated at build time by scripts/entity_table_gen.py.
+ */
+class EntityNameIndex
+{
+  public:
+    struct Entry
+    {
+        std::uint16_t key; // id << 8 | instance
+        std::uint16_t nameLength;
+        std::uint32_t nameOffset;
+
+        std::uint8_t id() const
+        {
+            return key >> 8;
+        }
+
+        std::uint8_t instance() const
+        {
+            return key & 0xff;
+        }
+    };
+
+    /**
+     * One name for an entity, as gathered from a source other than the JSON
+     * map.
+     */
+    struct Record
+    {
+        std::uint8_t id;
+        std::uint8_t instance;
+        std::string_view name;
+    };
+
+    EntityNameIndex() = default;
+
+    /**
+     * Build the index from a parsed entity association map.
+     *
+     * Matches readNameFromConfig: the first record for an instance wins, and
+     * a record without a name hides any later record for that instance.
+     * Malformed records are skipped.
+     *
+     * @param[in] config - the json object holding the entity mapping
+     */
+    explicit EntityNameIndex(const nlohmann::json& config);
+
+    /**
+     * Build the index from a list of records. The first record for an entity
+     * wins and records with an empty name are skipped.
+     *
+     * @param[in] records - the names, in order of preference
+     */
+    explicit EntityNameIndex(std::span<const Record> records);
+
+    /**
+     * View a table that outlives the index, such as a generated one.
+     *
+     * @param[in] entries - entries sorted by key, with no duplicate keys
+     * @param[in] names - the storage the entries point into
+     */
+    EntityNameIndex(std::span<const Entry> entries, std::string_view names) :
+        entries(entries), names(names)
+    {}
+
+    // The views may point into this object's own storage.
+    EntityNameIndex(const EntityNameIndex&) = delete;
+    EntityNameIndex& operator=(const EntityNameIndex&) = delete;
+
+    /**
+     * Return the name for an entity.
+     *
+     * @param[in] id - the entity id value
+     * @param[in] instance - the entity instance
+     * @return a view into the index, or std::nullopt if there is no name.
+     */
+    std::optional<std::string_view> find(std::uint8_t id,
+                                         std::uint8_t instance) const;
+
+    /**
+     * Return the entries at or after an entity, in (id, instance) order.
+     *
+     * @param[in] id - the entity id value to start from
+     * @param[in] instance - the entity instance to start from
+     * @return the remaining entries.
+     */
+    std::span<const Entry> from(std::uint8_t id, std::uint8_t instance) const;
+
+    /**
+     * Return the name of an entry returned by from().
+     */
+    std::string_view name(const Entry& entry) const
+    {
+        return names.substr(entry.nameOffset, entry.nameLength);
+    }
+
+    std::size_t size() const
+    {
+        return entries.size();
+    }
+
+    bool empty() const
+    {
+        return entries.empty();
+    }
+
+  private:
+    // records holds (key, name) pairs; an empty name hides later records for
+    // the same key without being served.
+    void assign(
+        std::vector<std::pair<std::uint16_t, std::string_view>>& records);
+
+    std::vector<Entry> ownedEntries;
+    std::string ownedNames;
+    std::span<const Entry> entries;
+    std::string_view names;
+};
+
+} // namespace ipmi
+} // namespace google
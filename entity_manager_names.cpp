@@ -0,0 +1,260 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "entity_manager_names.hpp"
+
+#include "entity_index.hpp"
+
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
+#include <stdplus/print.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace
+{
+
+constexpr char entityManagerService[] = "xyz.openbmc_project.EntityManager";
+constexpr char inventoryRoot[] = "/xyz/openbmc_project/inventory";
+
+std::optional<std::uint8_t> toByte(const EntityManagerNames::Value& value)
+{
+    return std::visit(
+        [](const auto& v) -> std::optional<std::uint8_t> {
+            using T = std::decay_t<decltype(v)>;
+            // Entity Manager stores JSON numbers as int64, uint64 or double;
+            // only whole numbers in range name an entity.
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                if (v >= 0 && v <= 0xff && v == std::trunc(v))
+                {
+                    return static_cast<std::uint8_t>(v);
+                }
+            }
+            else if constexpr (std::is_integral_v<T> &&
+                               !std::is_same_v<T, bool>)
+            {
+                if (std::in_range<std::uint8_t>(v))
+                {
+                    return static_cast<std::uint8_t>(v);
+                }
+            }
+            return std::nullopt;
+        },
+        value);
+}
+
+std::string leafName(const std::string& path)
+{
+    return path.substr(path.rfind('/') + 1);
+}
+
+} // namespace
+
+void EntityManagerNames::start(
+    const std::shared_ptr<sdbusplus::asio::connection>& bus)
+{
+    namespace rules = sdbusplus::bus::match::rules;
+
+    this->bus = bus;
+    matches.emplace_back(
+        *bus,
+        rules::interfacesAdded() + rules::sender(entityManagerService),
+        [this](sdbusplus::message_t& msg) {
+            sdbusplus::message::object_path path;
+            InterfaceMap interfaces;
+            try
+            {
+                msg.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception_t& e)
+            {
+                stdplus::print(stderr, "Bad InterfacesAdded signal: {}\n",
+                               e.what());
+                return;
+            }
+            interfacesAdded(path.str, interfaces);
+        });
+    matches.emplace_back(
+        *bus,
+        rules::interfacesRemoved() + rules::sender(entityManagerService),
+        [this](sdbusplus::message_t& msg) {
+            sdbusplus::message::object_path path;
+            std::vector<std::string> interfaces;
+            try
+            {
+                msg.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception_t& e)
+            {
+                stdplus::print(stderr, "Bad InterfacesRemoved signal: {}\n",
+                               e.what());
+                return;
+            }
+            interfacesRemoved(path.str, interfaces);
+        });
+    // A restarted Entity Manager re-creates its objects without announcing
+    // them, so start over from a new snapshot.
+    matches.emplace_back(
+        *bus, rules::nameOwnerChanged(entityManagerService),
+        [this](sdbusplus::message_t& msg) {
+            std::string name, oldOwner, newOwner;
+            try
+            {
+                msg.read(name, oldOwner, newOwner);
+            }
+            catch (const sdbusplus::exception_t& e)
+            {
+                stdplus::print(stderr, "Bad NameOwnerChanged signal: {}\n",
+                               e.what());
+                return;
+            }
+            if (newOwner.empty())
+            {
+                clear();
+            }
+            else
+            {
+                snapshot();
+            }
+        });
+
+    snapshot();
+}
+
+void EntityManagerNames::snapshot()
+{
+    bus->async_method_call(
+        [this](const boost::system::error_code& ec,
+               const ManagedObjects& objects) {
+            if (ec)
+            {
+                // Entity Manager is not up yet; NameOwnerChanged will tell us
+                // when it is. Until then there are no names to serve.
+                stdplus::print(stderr,
+                               "Failed to read Entity Manager inventory: {}\n",
+                               ec.message());
+                if (!current.load())
+                {
+                    clear();
+                }
+                return;
+            }
+            replace(objects);
+        },
+        entityManagerService, inventoryRoot,
+        "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
+}
+
+void EntityManagerNames::replace(const ManagedObjects& objects)
+{
+    names.clear();
+    for (const auto& [path, interfaces] : objects)
+    {
+        add(path.str, interfaces);
+    }
+    publish();
+}
+
+void EntityManagerNames::interfacesAdded(const std::string& path,
+                                         const InterfaceMap& interfaces)
+{
+    add(path, interfaces);
+    publish();
+}
+
+void EntityManagerNames::interfacesRemoved(
+    const std::string& path, const std::vector<std::string>& interfaces)
+{
+    bool changed = false;
+    for (const auto& interface : interfaces)
+    {
+        changed |= names.erase({path, interface}) > 0;
+    }
+    if (changed)
+    {
+        publish();
+    }
+}
+
+void EntityManagerNames::clear()
+{
+    names.clear();
+    publish();
+}
+
+void EntityManagerNames::add(const std::string& path,
+                             const InterfaceMap& interfaces)
+{
+    for (const auto& [interface, properties] : interfaces)
+    {
+        auto id = properties.find("EntityId");
+        auto instance = properties.find("EntityInstance");
+        if (id == properties.end() || instance == properties.end())
+        {
+            continue;
+        }
+        auto idByte = toByte(id->second);
+        auto instanceByte = toByte(instance->second);
+        if (!idByte || !instanceByte)
+        {
+            continue;
+        }
+
+        std::string name;
+        if (auto it = properties.find("Name"); it != properties.end())
+        {
+            if (const auto* s = std::get_if<std::string>(&it->second))
+            {
+                name = *s;
+            }
+        }
+        if (name.empty())
+        {
+            name = leafName(path);
+        }
+        names.insert_or_assign({path, interface},
+                               Name{*idByte, *instanceByte, std::move(name)});
+    }
+}
+
+void EntityManagerNames::publish()
+{
+    std::vector<EntityNameIndex::Record> records;
+    records.reserve(names.size());
+    for (const auto& [key, entity] : names)
+    {
+        records.push_back({entity.id, entity.instance, entity.name});
+    }
+    current.store(std::make_shared<const EntityNameIndex>(records));
+}
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,111 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "entity_index.hpp"
+
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message/types.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * Keeps an EntityNameIndex built from the inventory Entity Manager publishes.
+ *
+ * Any inventory interface with EntityId and EntityInstance properties names
+ * that entity, by its Name property or else the last element of its object
+ * path. One GetManagedObjects snapshot is taken by start() and then kept
+ * current from InterfacesAdded and InterfacesRemoved, so lookups never wait
+ * on D-Bus. A new snapshot is taken whenever Entity Manager restarts.
+ */
+class EntityManagerNames
+{
+  public:
+    using Value =
+        std::variant<std::string, bool, std::uint8_t, std::int16_t,
+                     std::uint16_t, std::int32_t, std::uint32_t, std::int64_t,
+                     std::uint64_t, double, std::vector<std::string>,
+                     std::vector<double>, std::vector<std::uint64_t>,
+                     std::vector<std::int64_t>>;
+    using PropertyMap = std::map<std::string, Value>;
+    using InterfaceMap = std::map<std::string, PropertyMap>;
+    using ManagedObjects =
+        std::vector<std::pair<sdbusplus::message::object_path, InterfaceMap>>;
+
+    EntityManagerNames() = default;
+
+    EntityManagerNames(const EntityManagerNames&) = delete;
+    EntityManagerNames& operator=(const EntityManagerNames&) = delete;
+
+    /**
+     * Subscribe to inventory changes and request the first snapshot. Both
+     * complete on the connection's io_context.
+     *
+     * @param[in] bus - the connection to use.
+     */
+    void start(const std::shared_ptr<sdbusplus::asio::connection>& bus);
+
+    /**
+     * Return the current index, or nullptr before the first snapshot.
+     */
+    std::shared_ptr<const EntityNameIndex> index() const
+    {
+        return current.load();
+    }
+
+    // The updates applied for each reply and signal, public for testing.
+    void replace(const ManagedObjects& objects);
+    void interfacesAdded(const std::string& path,
+                         const InterfaceMap& interfaces);
+    void interfacesRemoved(const std::string& path,
+                           const std::vector<std::string>& interfaces);
+    void clear();
+
+  private:
+    struct Name
+    {
+        std::uint8_t id;
+        std::uint8_t instance;
+        std::string name;
+    };
+
+    void snapshot();
+    void add(const std::string& path, const InterfaceMap& interfaces);
+    void publish();
+
+    // Keyed by (path, interface), so when several objects claim the same
+    // entity the same one wins on every rebuild.
+    std::map<std::pair<std::string, std::string>, Name> names;
+    std::atomic<std::shared_ptr<const EntityNameIndex>> current;
+
+    std::shared_ptr<sdbusplus::asio::connection> bus;
+    std::vector<sdbusplus::bus::match_t> matches;
+};
+
+} // namespace ipmi
+} // namespace google
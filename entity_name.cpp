@@ -17,6 +17,7 @@
 #include "commands.hpp"
 #include "errors.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
 
 #include <ipmid/api-types.hpp>
 #include <stdplus/print.hpp>
@@ -25,6 +26,8 @@
 #include <cstring>
 #include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -59,16 +62,13 @@ Resp getEntityName(std::span<const uint8_t> data, HandlerInterface* handler)
     }
 
     std::memcpy(&request, data.data(), sizeof(request));
-    std::string entityName;
-    try
+    auto name =
+        handler->getEntityName(request.entityId, request.entityInstance);
+    if (!name)
     {
-        entityName =
-            handler->getEntityName(request.entityId, request.entityInstance);
-    }
-    catch (const IpmiException& e)
-    {
-        return ::ipmi::response(e.getIpmiError());
+        return ::ipmi::response(name.error());
     }
+    const std::string& entityName = *name;
 
     int length = sizeof(struct GetEntityNameReply) + entityName.length();
 
@@ -87,5 +87,52 @@ Resp getEntityName(std::span<const uint8_t> data, HandlerInterface* handler)
 
     return ::ipmi::responseSuccess(SysOEMCommands::SysEntityName, reply);
 }
+
+Resp getEntityNameList(std::span<const uint8_t> data,
+                       HandlerInterface* handler)
+{
+    struct GetEntityNameListRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+    auto index = handler->getEntityNameIndex();
+    if (!index)
+    {
+        return ::ipmi::response(index.error());
+    }
+
+    using Page = PagedReply<struct GetEntityNameListReply>;
+    Page page;
+    for (const auto& entry :
+         (*index)->from(request.entityId, request.entityInstance))
+    {
+        std::string_view name = (*index)->name(entry);
+        size_t recordLength = sizeof(struct EntityNameRecord) + name.size();
+        if (recordLength > Page::maxRecordLength)
+        {
+            // Can never fit in a reply; SysEntityName still serves it.
+            stdplus::print(stderr, "Skipping entity {}:{}, name too long\n",
+                           entry.id(), entry.instance());
+            continue;
+        }
+        if (page.full(recordLength))
+        {
+            page.header.nextEntityId = entry.id();
+            page.header.nextEntityInstance = entry.instance();
+            break;
+        }
+
+        page.add(entry.id(), entry.instance(),
+                 static_cast<std::uint8_t>(name.size()), name);
+    }
+
+    return ::ipmi::responseSuccess(SysOEMCommands::SysEntityNameList,
+                                   std::move(page).bytes());
+}
 } // namespace ipmi
 } // namespace google
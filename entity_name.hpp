@@ -37,5 +37,31 @@ struct GetEntityNameReply
 // Sys can query the entity name for a particular "entity id:entity instance".
 Resp getEntityName(std::span<const uint8_t> data, HandlerInterface* handler);
 
+struct GetEntityNameListRequest
+{
+    uint8_t entityId;
+    uint8_t entityInstance;
+} __attribute__((packed));
+
+struct GetEntityNameListReply
+{
+    uint8_t more;
+    uint8_t nextEntityId;
+    uint8_t nextEntityInstance;
+    uint8_t recordCount;
+} __attribute__((packed));
+
+struct EntityNameRecord
+{
+    uint8_t entityId;
+    uint8_t entityInstance;
+    uint8_t entityNameLength;
+} __attribute__((packed));
+
+// Handle the paged listing of every "entity id:entity instance" to entity name
+// mapping, starting from the "entity id:entity instance" in the request.
+Resp getEntityNameList(std::span<const uint8_t> data,
+                       HandlerInterface* handler);
+
 } // namespace ipmi
 } // namespace google
@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <ipmid/api-types.hpp>
+
 #include <exception>
+#include <expected>
 #include <string>
 
 namespace google
@@ -49,5 +52,13 @@ class IpmiException : public std::exception
     int _ipmicc;
 };
 
+/**
+ * The non-throwing counterpart to IpmiException, for Handler calls a host can
+ * drive into failure repeatedly (a missing file, a dead service). Carries the
+ * IPMI return code to use for the error.
+ */
+template <typename T>
+using Result = std::expected<T, ::ipmi::Cc>;
+
 } // namespace ipmi
 } // namespace google
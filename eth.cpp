@@ -16,6 +16,7 @@
 
 #include "commands.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
 
 #include <ipmid/api-types.hpp>
 #include <stdplus/print.hpp>
@@ -24,7 +25,9 @@
 #include <cstring>
 #include <span>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -38,11 +41,11 @@ namespace ipmi
 #define MAX_IPMI_BUFFER 64
 #endif
 
-Resp getEthDevice(std::span<const uint8_t> data,
-                  const HandlerInterface* handler)
+Resp getEthDevice(std::span<const uint8_t> data, HandlerInterface* handler)
 {
-    std::tuple<std::uint8_t, std::string> details =
-        handler->getEthDetails(std::string(data.begin(), data.end()));
+    std::tuple<std::uint8_t, std::string> details = handler->getEthDetails(
+        std::string_view(reinterpret_cast<const char*>(data.data()),
+                         data.size()));
 
     std::string device = std::get<1>(details);
     if (device.length() == 0)
@@ -66,5 +69,48 @@ Resp getEthDevice(std::span<const uint8_t> data,
     return ::ipmi::responseSuccess(SysOEMCommands::SysGetEthDevice, reply);
 }
 
+Resp getEthDevices(std::span<const uint8_t> data, HandlerInterface* handler)
+{
+    struct EthDevicesRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+
+    auto devices = handler->getEthDevices();
+    if (request.entry > 0 && request.entry >= devices.size())
+    {
+        return ::ipmi::responseParmOutOfRange();
+    }
+
+    using Page = PagedReply<struct EthDevicesReply>;
+    Page page;
+    for (size_t entry = request.entry; entry < devices.size(); ++entry)
+    {
+        const auto& [channel, device] = devices[entry];
+        size_t recordLength = sizeof(struct EthDeviceReply) + device.length();
+        if (recordLength > Page::maxRecordLength)
+        {
+            stdplus::print(stderr, "Skipping {}, too long to reply with\n",
+                           device);
+            continue;
+        }
+        if (page.full(recordLength))
+        {
+            page.header.nextEntry = entry;
+            break;
+        }
+
+        page.add(channel, static_cast<std::uint8_t>(device.length()), device);
+    }
+
+    return ::ipmi::responseSuccess(SysOEMCommands::SysGetEthDevices,
+                                   std::move(page).bytes());
+}
+
 } // namespace ipmi
 } // namespace google
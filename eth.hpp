@@ -40,8 +40,24 @@ struct EthDeviceReply
 // Handle the eth query command.
 // Sys can query the ifName and IPMI channel of the BMC's NCSI ethernet
 // device.
-Resp getEthDevice(std::span<const uint8_t> data,
-                  const HandlerInterface* handler);
+Resp getEthDevice(std::span<const uint8_t> data, HandlerInterface* handler);
+
+struct EthDevicesRequest
+{
+    uint8_t entry;
+} __attribute__((packed));
+
+struct EthDevicesReply
+{
+    uint8_t more;
+    uint8_t nextEntry;
+    uint8_t recordCount;
+} __attribute__((packed));
+
+// Handle the query of every ethernet device. Sys can read as many
+// (channel, ifName) records, each laid out as an EthDeviceReply, as fit in a
+// reply, starting at an entry.
+Resp getEthDevices(std::span<const uint8_t> data, HandlerInterface* handler);
 
 } // namespace ipmi
 } // namespace google
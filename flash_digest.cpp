@@ -0,0 +1,210 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "flash_digest.hpp"
+
+#include "scoped_fd.hpp"
+
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace
+{
+
+// Reads are whole erase blocks, and at least this much.
+constexpr size_t minReadSize = 1 << 20;
+
+} // namespace
+
+FlashDigest::FlashDigest(std::string devDir) : devDir(std::move(devDir)) {}
+
+FlashDigest::~FlashDigest()
+{
+    {
+        std::lock_guard guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+std::expected<std::optional<Sha256>, int> FlashDigest::get(
+    const MtdPartition& partition, bool rescan)
+{
+    std::lock_guard guard(lock);
+
+    bool busy =
+        running == partition.index ||
+        std::ranges::find(queue, partition.index, &Job::index) != queue.end();
+    auto it = digests.find(partition.index);
+    bool current = it != digests.end() && it->second.epoch == epoch;
+    if (rescan && !busy && !(current && !it->second.returned))
+    {
+        ++epoch;
+        current = false;
+    }
+
+    if (current)
+    {
+        if (it->second.digest)
+        {
+            it->second.returned = true;
+            return *it->second.digest;
+        }
+        // Report a failure once, then try again on the next request.
+        int err = it->second.digest.error();
+        digests.erase(it);
+        return std::unexpected(err);
+    }
+
+    if (!busy)
+    {
+        queue.push_back(Job{partition.index, partition.eraseSize});
+        if (!thread.joinable())
+        {
+            thread = std::thread(&FlashDigest::run, this);
+        }
+        wake.notify_one();
+    }
+    return std::nullopt;
+}
+
+void FlashDigest::invalidate()
+{
+    std::lock_guard guard(lock);
+    ++epoch;
+}
+
+void FlashDigest::run()
+{
+    std::unique_lock guard(lock);
+    while (true)
+    {
+        wake.wait(guard, [this]() { return stopping || !queue.empty(); });
+        if (stopping)
+        {
+            return;
+        }
+
+        Job job = queue.front();
+        queue.pop_front();
+        running = job.index;
+        std::uint64_t started = epoch;
+
+        guard.unlock();
+        auto digest = hash(job, started);
+        guard.lock();
+
+        running.reset();
+        if (stopping)
+        {
+            return;
+        }
+        if (epoch != started)
+        {
+            // The device may have changed part way through; start over.
+            queue.push_back(job);
+            continue;
+        }
+        digests.insert_or_assign(job.index, Entry{started, std::move(digest)});
+    }
+}
+
+std::expected<Sha256, int> FlashDigest::hash(const Job& job,
+                                            std::uint64_t started)
+{
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(
+        EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    if (!ctx || EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr) != 1)
+    {
+        return std::unexpected(ENOMEM);
+    }
+
+    std::string path = std::format("{}/mtd{}", devDir, job.index);
+    ScopedFd fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.get() < 0)
+    {
+        return std::unexpected(errno);
+    }
+
+    size_t blockSize = std::max<size_t>(job.eraseSize, 1);
+    std::vector<char> buf(std::max<size_t>(1, minReadSize / blockSize) *
+                          blockSize);
+    off_t offset = 0;
+    int err = 0;
+    while (true)
+    {
+        {
+            std::lock_guard guard(lock);
+            if (stopping || epoch != started)
+            {
+                err = ECANCELED;
+                break;
+            }
+        }
+
+        ssize_t len = ::pread(fd.get(), buf.data(), buf.size(), offset);
+        if (len < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (len <= 0)
+        {
+            err = len < 0 ? errno : 0;
+            break;
+        }
+        if (EVP_DigestUpdate(ctx.get(), buf.data(), len) != 1)
+        {
+            err = EIO;
+            break;
+        }
+        offset += len;
+    }
+    fd.reset();
+    if (err)
+    {
+        return std::unexpected(err);
+    }
+
+    Sha256 digest;
+    if (EVP_DigestFinal_ex(ctx.get(), digest.data(), nullptr) != 1)
+    {
+        return std::unexpected(EIO);
+    }
+    return digest;
+}
+
+} // namespace ipmi
+} // namespace google
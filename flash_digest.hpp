@@ -0,0 +1,106 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "mtd_partitions.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace google
+{
+namespace ipmi
+{
+
+using Sha256 = std::array<std::uint8_t, 32>;
+
+/**
+ * Hashes MTD devices on a thread of its own, so a request never waits for a
+ * whole partition to be read.
+ *
+ * A digest is kept until a rescan or invalidate() forgets every digest; the
+ * devices overlap, so a change to one may change any other. Writes to a device
+ * are not seen, so a digest is only as fresh as the last rescan. Each digest
+ * records the epoch it was started in; one finished after that is not served.
+ * Every hash reads the whole device; nothing is kept per erase block.
+ */
+class FlashDigest
+{
+  public:
+    /** @param[in] devDir - where the mtd<index> devices are. */
+    explicit FlashDigest(std::string devDir = "/dev");
+    ~FlashDigest();
+
+    FlashDigest(const FlashDigest&) = delete;
+    FlashDigest& operator=(const FlashDigest&) = delete;
+
+    /**
+     * Get the digest of a device, or start hashing it.
+     *
+     * A rescan is ignored while the device is queued or being hashed, and
+     * while its digest has not been returned yet, so polling with rescan set
+     * still ends with a digest.
+     *
+     * @param[in] partition - the device to hash.
+     * @param[in] rescan - forget every digest and hash the device again.
+     * @return the digest, std::nullopt while it is being worked out, or the
+     *         errno of the last attempt.
+     */
+    std::expected<std::optional<Sha256>, int> get(
+        const MtdPartition& partition, bool rescan = false);
+
+    /** Forget every digest, and restart any being worked out. */
+    void invalidate();
+
+  private:
+    struct Entry
+    {
+        std::uint64_t epoch;
+        std::expected<Sha256, int> digest;
+        bool returned = false;
+    };
+
+    struct Job
+    {
+        unsigned int index;
+        std::uint32_t eraseSize;
+    };
+
+    void run();
+    std::expected<Sha256, int> hash(const Job& job, std::uint64_t started);
+
+    std::string devDir;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::uint64_t epoch = 0;
+    std::map<unsigned int, Entry> digests;
+    std::deque<Job> queue;
+    // The device the thread is hashing, if any.
+    std::optional<unsigned int> running;
+    bool stopping = false;
+    std::thread thread;
+};
+
+} // namespace ipmi
+} // namespace google
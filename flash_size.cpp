@@ -17,13 +17,16 @@
 #include "commands.hpp"
 #include "errors.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
 
 #include <ipmid/api-types.hpp>
+#include <stdplus/print.hpp>
 
 #include <cstdint>
 #include <cstring>
 #include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -50,5 +53,92 @@ Resp getFlashSize(std::span<const uint8_t>, HandlerInterface* handler)
             (std::uint8_t*)&(flashSize),
             (std::uint8_t*)&(flashSize) + sizeof(std::uint32_t)));
 }
+
+Resp mtdPartitions(std::span<const uint8_t> data, HandlerInterface* handler)
+{
+    struct MtdPartitionsRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+
+    auto partitions = handler->getMtdPartitions();
+    if (!partitions)
+    {
+        return ::ipmi::response(partitions.error());
+    }
+    if (request.entry > 0 && request.entry >= partitions->size())
+    {
+        return ::ipmi::responseParmOutOfRange();
+    }
+
+    using Page = PagedReply<struct MtdPartitionsReply>;
+    Page page;
+    for (size_t entry = request.entry; entry < partitions->size(); ++entry)
+    {
+        const auto& partition = (*partitions)[entry];
+        size_t recordLength =
+            sizeof(struct MtdPartitionsRecord) + partition.name.size();
+        if (recordLength > Page::maxRecordLength ||
+            partition.index > UINT8_MAX)
+        {
+            stdplus::print(stderr, "Skipping mtd{}, does not fit a record\n",
+                           partition.index);
+            continue;
+        }
+        if (page.full(recordLength))
+        {
+            page.header.nextEntry = entry;
+            break;
+        }
+
+        struct MtdPartitionsRecord record = {};
+        record.index = partition.index;
+        record.size = htole32(partition.size);
+        record.eraseSize = htole32(partition.eraseSize);
+        record.flags = htole32(partition.flags);
+        record.nameLength = partition.name.size();
+        page.add(record, partition.name);
+    }
+
+    return ::ipmi::responseSuccess(SysOEMCommands::SysMtdPartitions,
+                                   std::move(page).bytes());
+}
+
+Resp flashDigest(std::span<const uint8_t> data, HandlerInterface* handler)
+{
+    struct FlashDigestRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+
+    auto digest = handler->getFlashDigest(request.mtd,
+                                          request.flags & flashDigestRescan);
+    if (!digest)
+    {
+        return ::ipmi::response(digest.error());
+    }
+
+    std::vector<std::uint8_t> reply;
+    if (!*digest)
+    {
+        reply.push_back(flashDigestPending);
+    }
+    else
+    {
+        reply.push_back(flashDigestReady);
+        reply.insert(reply.end(), (*digest)->begin(), (*digest)->end());
+    }
+    return ::ipmi::responseSuccess(SysOEMCommands::SysFlashFullDigest, reply);
+}
 } // namespace ipmi
 } // namespace google
@@ -34,5 +34,56 @@ struct GetFlashSizeReply
 
 Resp getFlashSize(std::span<const uint8_t> data, HandlerInterface* handler);
 
+struct MtdPartitionsRequest
+{
+    uint8_t entry;
+} __attribute__((packed));
+
+struct MtdPartitionsReply
+{
+    uint8_t more;
+    uint8_t nextEntry;
+    uint8_t recordCount;
+} __attribute__((packed));
+
+struct MtdPartitionsRecord
+{
+    uint8_t index;
+    // Little endian.
+    uint32_t size;
+    uint32_t eraseSize;
+    uint32_t flags;
+    uint8_t nameLength;
+} __attribute__((packed));
+
+// Return the partition table of the bmc flash, as many MTD devices as fit in
+// a reply, starting at an entry.
+Resp mtdPartitions(std::span<const uint8_t> data, HandlerInterface* handler);
+
+// Bits of FlashDigestRequest::flags.
+enum FlashDigestFlags : uint8_t
+{
+    // Forget every digest and hash the device again.
+    flashDigestRescan = 1 << 0,
+};
+
+struct FlashDigestRequest
+{
+    uint8_t mtd;
+    uint8_t flags;
+} __attribute__((packed));
+
+enum FlashDigestStatus : uint8_t
+{
+    // The digest follows.
+    flashDigestReady = 0,
+    // The device is being hashed; ask again later.
+    flashDigestPending = 1,
+};
+
+// Return the SHA-256 of an MTD device. The first request starts hashing it in
+// the background and later ones return the digest once it is done.
+Resp flashDigest(std::span<const uint8_t> data, HandlerInterface* handler);
+
 } // namespace ipmi
 } // namespace google
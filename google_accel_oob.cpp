@@ -68,11 +68,15 @@ Resp accelOobDeviceCount(std::span<const uint8_t> data,
         return ::ipmi::responseReqDataLenExceeded();
     }
 
-    uint32_t count = handler->accelOobDeviceCount();
+    auto count = handler->accelOobDeviceCount();
+    if (!count)
+    {
+        return ::ipmi::response(count.error());
+    }
 
     std::vector<uint8_t> replyBuf(sizeof(Reply));
     auto* reply = reinterpret_cast<Reply*>(replyBuf.data());
-    reply->count = count;
+    reply->count = *count;
 
     return ::ipmi::responseSuccess(SysOEMCommands::SysAccelOobDeviceCount,
                                    replyBuf);
@@ -110,7 +114,12 @@ Resp accelOobDeviceName(std::span<const uint8_t> data,
     }
 
     auto* req = reinterpret_cast<const Request*>(data.data());
-    std::string name = handler->accelOobDeviceName(req->index);
+    auto result = handler->accelOobDeviceName(req->index);
+    if (!result)
+    {
+        return ::ipmi::response(result.error());
+    }
+    const std::string& name = *result;
 
     if (name.size() > MAX_NAME_SIZE)
     {
@@ -224,12 +233,16 @@ Resp accelOobRead(std::span<const uint8_t> data, HandlerInterface* handler)
     }
 
     auto req = reinterpret_cast<const Request*>(payload);
-    uint64_t r = handler->accelOobRead(name, req->address, req->num_bytes);
+    auto r = handler->accelOobRead(name, req->address, req->num_bytes);
+    if (!r)
+    {
+        return ::ipmi::response(r.error());
+    }
 
     std::vector<uint8_t> replyBuf(data.size_bytes() + sizeof(Reply));
     std::copy(data.begin(), data.end(), replyBuf.data());
     auto* reply = reinterpret_cast<Reply*>(replyBuf.data() + data.size_bytes());
-    reply->data = r;
+    reply->data = *r;
 
     return ::ipmi::responseSuccess(SysOEMCommands::SysAccelOobRead, replyBuf);
 }
@@ -276,7 +289,12 @@ Resp accelOobWrite(std::span<const uint8_t> data, HandlerInterface* handler)
     }
 
     auto req = reinterpret_cast<const Request*>(payload);
-    handler->accelOobWrite(name, req->address, req->num_bytes, req->data);
+    auto r = handler->accelOobWrite(name, req->address, req->num_bytes,
+                                    req->data);
+    if (!r)
+    {
+        return ::ipmi::response(r.error());
+    }
 
     std::vector<uint8_t> replyBuf(data.size_bytes() + sizeof(Reply));
     std::copy(data.begin(), data.end(), replyBuf.data());
@@ -287,7 +305,6 @@ Resp accelOobWrite(std::span<const uint8_t> data, HandlerInterface* handler)
 Resp accelGetVrSettings(::ipmi::Context::ptr ctx, std::span<const uint8_t> data,
                         HandlerInterface* handler)
 {
-    uint16_t value;
     if (data.size_bytes() != 2)
     {
         stdplus::println(
@@ -297,19 +314,16 @@ Resp accelGetVrSettings(::ipmi::Context::ptr ctx, std::span<const uint8_t> data,
         return ::ipmi::responseReqDataLenInvalid();
     }
 
-    try
-    {
-        value = handler->accelGetVrSettings(ctx, /*chip_id*/ data[0],
-                                            /*settings_id*/ data[1]);
-    }
-    catch (const IpmiException& e)
+    auto value = handler->accelGetVrSettings(ctx, /*chip_id*/ data[0],
+                                             /*settings_id*/ data[1]);
+    if (!value)
     {
-        return ::ipmi::response(e.getIpmiError());
+        return ::ipmi::response(value.error());
     }
     return ::ipmi::responseSuccess(
         SysOEMCommands::SysGetAccelVrSettings,
-        std::vector<uint8_t>{static_cast<uint8_t>(value),
-                             static_cast<uint8_t>(value >> 8)});
+        std::vector<uint8_t>{static_cast<uint8_t>(*value),
+                             static_cast<uint8_t>(*value >> 8)});
 }
 
 Resp accelSetVrSettings(::ipmi::Context::ptr ctx, std::span<const uint8_t> data,
@@ -324,14 +338,12 @@ Resp accelSetVrSettings(::ipmi::Context::ptr ctx, std::span<const uint8_t> data,
         return ::ipmi::responseReqDataLenInvalid();
     }
     uint16_t value = static_cast<uint16_t>(data[2] | data[3] << 8);
-    try
-    {
-        handler->accelSetVrSettings(ctx, /*chip_id*/ data[0],
-                                    /*settings_id*/ data[1], /*value*/ value);
-    }
-    catch (const IpmiException& e)
+    auto r = handler->accelSetVrSettings(ctx, /*chip_id*/ data[0],
+                                         /*settings_id*/ data[1],
+                                         /*value*/ value);
+    if (!r)
     {
-        return ::ipmi::response(e.getIpmiError());
+        return ::ipmi::response(r.error());
     }
     return ::ipmi::responseSuccess(SysOEMCommands::SysSetAccelVrSettings,
                                    std::vector<uint8_t>{});
@@ -20,36 +20,52 @@
 
 #include "bm_instance.hpp"
 #include "bmc_mode_enum.hpp"
+#include "cached_file_reader.hpp"
+#include "cpld.hpp"
+#include "entity_manager_names.hpp"
 #include "errors.hpp"
 #include "handler_impl.hpp"
+#include "tracing.hpp"
 #include "util.hpp"
 
+#if STATIC_ENTITY_TABLE
+#include "entity_table.hpp"
+#endif
+
 #include <fcntl.h>
+#include <linux/if.h>
 #include <ipmid/api.h>
-#include <mtd/mtd-abi.h>
-#include <mtd/mtd-user.h>
-#include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 #include <stdplus/print.hpp>
+#include <user_channel/channel_layer.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
-#include <cinttypes>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #ifndef NCSI_IF_NAME
 #define NCSI_IF_NAME eth0
@@ -60,11 +76,6 @@
 #define STR(macro) QUOTE(macro)
 #define NCSI_IF_NAME_STR STR(NCSI_IF_NAME)
 
-namespace ipmi
-{
-std::uint8_t getChannelByName(const std::string& chName);
-}
-
 namespace google
 {
 namespace ipmi
@@ -84,10 +95,6 @@ uint8_t isBmcInBareMetalMode(const std::unique_ptr<FileSystemInterface>& fs)
 
     if (fs->exists(bmDriveCleaningDoneAckFlagPath, ec))
     {
-        stdplus::print(
-            stderr,
-            "{} exists so we acked cleaning done and must be in BM mode\n",
-            bmDriveCleaningDoneAckFlagPath);
         return static_cast<uint8_t>(BmcMode::BM_MODE);
     }
 
@@ -108,42 +115,189 @@ uint8_t isBmcInBareMetalMode(const std::unique_ptr<FileSystemInterface>& fs)
         {
             fs->create(bmDriveCleaningFlagPath);
         }
-
-        stdplus::print(
-            stderr,
-            "{} exists and no done/ack flag, we must be in BM cleaning mode\n",
-            BM_SIGNAL_PATH);
         return static_cast<uint8_t>(BmcMode::BM_CLEANING_MODE);
     }
 
-    stdplus::print(
-        stderr,
-        "Unable to find any BM state files so we must not be in BM mode\n");
     return static_cast<uint8_t>(BmcMode::NON_BM_MODE);
 #endif
 }
 
+#if !BARE_METAL
+namespace
+{
+
+// Say which flag files the mode was worked out from.
+void printBmcMode(uint8_t mode)
+{
+    switch (static_cast<BmcMode>(mode))
+    {
+        case BmcMode::BM_MODE:
+            stdplus::print(
+                stderr,
+                "{} exists so we acked cleaning done and must be in BM mode\n",
+                bmDriveCleaningDoneAckFlagPath);
+            break;
+        case BmcMode::BM_CLEANING_MODE:
+            stdplus::print(stderr,
+                           "{} exists and no done/ack flag, we must be in BM "
+                           "cleaning mode\n",
+                           BM_SIGNAL_PATH);
+            break;
+        case BmcMode::NON_BM_MODE:
+            stdplus::print(stderr, "Unable to find any BM state files so we "
+                                   "must not be in BM mode\n");
+            break;
+    }
+}
+
+} // namespace
+#endif
+
 uint8_t Handler::getBmcMode()
 {
-    // BM_CLEANING_MODE is not implemented yet
-    return isBmcInBareMetalMode(this->getFs());
+#if BARE_METAL
+    return static_cast<uint8_t>(BmcMode::BM_MODE);
+#else
+    return _bmcMode.get([this](std::uint8_t& mode) {
+        // Only log the mode when it changes.
+        uint8_t previous =
+            std::exchange(mode, isBmcInBareMetalMode(this->getFs()));
+        if (!_bmcModeReported || mode != previous)
+        {
+            _bmcModeReported = true;
+            printBmcMode(mode);
+        }
+    });
+#endif
+}
+
+void Handler::wakeBmcModeWaiters()
+{
+    // The timers belong to the IPMI thread, so cancel them there.
+    std::lock_guard guard(_bmcModeWaitLock);
+    for (const auto& timer : _bmcModeWaiters)
+    {
+        boost::asio::post(timer->get_executor(),
+                          [timer]() { timer->cancel(); });
+    }
+}
+
+uint8_t Handler::waitBmcModeChange(::ipmi::Context::ptr ctx, uint8_t lastMode,
+                                   std::chrono::milliseconds timeout)
+{
+    return waitBmcModeChange(ctx->bus->get_io_context(), ctx->yield, lastMode,
+                             timeout);
+}
+
+uint8_t Handler::waitBmcModeChange(boost::asio::io_context& io,
+                                   boost::asio::yield_context yield,
+                                   uint8_t lastMode,
+                                   std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto timer = std::make_shared<boost::asio::steady_timer>(io);
+
+    // Registered before the mode is checked, so a change in between still
+    // wakes the timer.
+    bool held = false;
+    {
+        std::lock_guard guard(_bmcModeWaitLock);
+        if (_bmcModeWaiters.size() < maxBmcModeWaiters)
+        {
+            _bmcModeWaiters.push_back(timer);
+            held = true;
+        }
+    }
+    if (!held)
+    {
+        stdplus::print(stderr, "Too many BMC mode waits, not waiting\n");
+        return getBmcMode();
+    }
+
+    uint8_t mode;
+    while ((mode = getBmcMode()) == lastMode &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        // Nothing wakes the timer if the flag files are not watched, so look
+        // again every second.
+        auto wake = deadline;
+        if (!_bmcMode.watched())
+        {
+            wake = std::min(deadline, std::chrono::steady_clock::now() +
+                                          std::chrono::seconds(1));
+        }
+        timer->expires_at(wake);
+
+        boost::system::error_code ec;
+        trace::SuspendScope suspend;
+        timer->async_wait(yield[ec]);
+    }
+
+    std::lock_guard guard(_bmcModeWaitLock);
+    std::erase(_bmcModeWaiters, timer);
+    return mode;
 }
 
 std::tuple<std::uint8_t, std::string> Handler::getEthDetails(
-    std::string intf) const
+    std::string_view intf)
 {
     if (intf.empty())
     {
         intf = NCSI_IF_NAME_STR;
     }
-    return std::make_tuple(::ipmi::getChannelByName(intf), std::move(intf));
+
+    for (const auto& [channel, name] : ethChannels())
+    {
+        if (name == intf)
+        {
+            return std::make_tuple(channel, name);
+        }
+    }
+
+    // Not a LAN channel of the config, so leave it to ipmid.
+    std::string name(intf);
+    return std::make_tuple(::ipmi::getChannelByName(name), std::move(name));
+}
+
+std::vector<std::tuple<std::uint8_t, std::string>> Handler::getEthDevices()
+{
+    return ethChannels();
+}
+
+const std::vector<std::tuple<std::uint8_t, std::string>>&
+    Handler::ethChannels()
+{
+    // ipmid loads its channel config once at startup, so ask it only once.
+    if (_ethChannels)
+    {
+        return *_ethChannels;
+    }
+
+    _ethChannels.emplace();
+    for (std::uint8_t channel = 0; channel < ::ipmi::maxIpmiChannels;
+         ++channel)
+    {
+        ::ipmi::ChannelInfo info;
+        if (!::ipmi::isValidChannel(channel) ||
+            ::ipmi::getChannelInfo(channel, info) != ::ipmi::ccSuccess ||
+            info.mediumType !=
+                static_cast<std::uint8_t>(::ipmi::EChannelMediumType::lan8032))
+        {
+            continue;
+        }
+        std::string name = ::ipmi::getChannelName(channel);
+        if (!name.empty())
+        {
+            _ethChannels->emplace_back(channel, std::move(name));
+        }
+    }
+    return *_ethChannels;
 }
 
-std::int64_t Handler::getRxPackets(const std::string& name) const
+Result<std::int64_t> Handler::getRxPackets(const std::string& name) const
 {
-    std::ostringstream opath;
-    opath << "/sys/class/net/" << name << "/statistics/rx_packets";
-    std::string path = opath.str();
+    std::string path =
+        std::format("/sys/class/net/{}/statistics/rx_packets", name);
 
     // Minor sanity & security check (of course, I'm less certain if unicode
     // comes into play here.
@@ -152,78 +306,183 @@ std::int64_t Handler::getRxPackets(const std::string& name) const
     if (name.find("/") != std::string::npos)
     {
         stdplus::print(stderr, "Invalid or illegal name: '{}'\n", name);
-        throw IpmiException(::ipmi::ccInvalidFieldRequest);
+        return std::unexpected(::ipmi::ccInvalidFieldRequest);
     }
 
-    std::error_code ec;
-    if (!this->getFs()->exists(path, ec))
+    trace::FileReadProbe probe(path.c_str());
+    std::array<char, 32> buf;
+    auto len = getFileReader().read(path, buf);
+    if (!len)
     {
-        stdplus::print(stderr, "Path: '{}' doesn't exist.\n", path);
-        throw IpmiException(::ipmi::ccInvalidFieldRequest);
+        if (len.error() == ENOENT)
+        {
+            stdplus::print(stderr, "Path: '{}' doesn't exist.\n", path);
+            return probe.fail(::ipmi::ccInvalidFieldRequest);
+        }
+        stdplus::print(stderr, "Failed to read '{}': {}\n", path,
+                       std::strerror(len.error()));
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
-    // We're uninterested in the state of ec.
 
-    int64_t count = 0;
-    std::ifstream ifs;
-    ifs.exceptions(std::ifstream::failbit);
-    try
+    auto count = parseInteger<std::int64_t>(std::string_view(buf.data(), *len));
+    if (!count)
     {
-        ifs.open(path);
-        ifs >> count;
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
-    catch (std::ios_base::failure& fail)
+
+    return *count;
+}
+
+namespace
+{
+
+std::string cpldVersionPath(const fs::path& dir, unsigned int id)
+{
+    return dir / std::format("cpld{}.version", id);
+}
+
+} // namespace
+
+Result<std::vector<LinkStatus>> Handler::getLinkStatuses(bool refresh)
+{
+    if (!refresh && _linkStatuses)
     {
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return *_linkStatuses;
+    }
+
+    auto links = dumpLinkStats();
+    if (!links)
+    {
+        stdplus::print(stderr, "Failed to dump links: {}\n",
+                       std::strerror(links.error()));
+        return std::unexpected(::ipmi::ccUnspecifiedError);
+    }
+
+    // A counter that went backwards was reset, as when an interface is
+    // recreated, so all of it is new.
+    auto delta = [](std::uint64_t now, std::uint64_t last) {
+        return now >= last ? now - last : now;
+    };
+
+    std::vector<LinkStatus> statuses;
+    std::unordered_map<int, std::tuple<std::uint64_t, std::uint64_t>> counters;
+    for (auto& link : *links)
+    {
+        if (link.flags & IFF_LOOPBACK)
+        {
+            continue;
+        }
+
+        std::uint64_t lastRx = 0;
+        std::uint64_t lastTx = 0;
+        if (auto it = _linkCounters.find(link.index); it != _linkCounters.end())
+        {
+            std::tie(lastRx, lastTx) = it->second;
+        }
+        counters.emplace(link.index,
+                         std::make_tuple(link.rxPackets, link.txPackets));
+        statuses.push_back(LinkStatus{link, delta(link.rxPackets, lastRx),
+                                      delta(link.txPackets, lastTx)});
     }
 
-    return count;
+    _linkCounters = std::move(counters);
+    _linkStatuses = std::move(statuses);
+    return *_linkStatuses;
 }
 
-VersionTuple Handler::getCpldVersion(unsigned int id) const
+Result<VersionTuple> Handler::readCpldVersion(const std::string& path) const
 {
-    std::ostringstream opath;
-    opath << "/run/cpld" << id << ".version";
-    // Check for file
+    trace::FileReadProbe probe(path.c_str());
 
-    std::error_code ec;
-    if (!this->getFs()->exists(opath.str(), ec))
+    std::array<char, 64> buf;
+    auto len = getFileReader().read(path, buf);
+    if (!len)
     {
-        stdplus::print(stderr, "Path: '{}' doesn't exist.\n", opath.str());
-        throw IpmiException(::ipmi::ccInvalidFieldRequest);
+        if (len.error() == ENOENT)
+        {
+            stdplus::print(stderr, "Path: '{}' doesn't exist.\n", path);
+            return probe.fail(::ipmi::ccInvalidFieldRequest);
+        }
+        stdplus::print(stderr, "Failed to read '{}': {}\n", path,
+                       std::strerror(len.error()));
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
-    // We're uninterested in the state of ec.
 
-    // If file exists, read.
-    std::ifstream ifs;
-    ifs.exceptions(std::ifstream::failbit);
-    std::string value;
-    try
+    auto value = firstToken(std::string_view(buf.data(), *len));
+    if (value.empty())
     {
-        ifs.open(opath.str());
-        ifs >> value;
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
-    catch (std::ios_base::failure& fail)
+
+    auto version = parseVersion(value);
+    if (!version)
     {
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        stdplus::print(stderr, "Invalid version.\n");
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
 
-    // If value parses as expected, return version.
-    VersionTuple version = std::make_tuple(0, 0, 0, 0);
+    return *version;
+}
 
-    int num_fields =
-        std::sscanf(value.c_str(), "%" SCNu8 ".%" SCNu8 ".%" SCNu8 ".%" SCNu8,
-                    &std::get<0>(version), &std::get<1>(version),
-                    &std::get<2>(version), &std::get<3>(version));
-    if (num_fields == 0)
+Result<VersionTuple> Handler::getCpldVersion(unsigned int id)
+{
+    // Without a watch, read just the one file rather than all of them.
+    std::string path = cpldVersionPath(getRunDir(), id);
+    if (!_cpldVersions.watched())
     {
-        stdplus::print(stderr, "Invalid version.\n");
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return readCpldVersion(path);
+    }
+
+    const auto& versions = cpldVersions();
+    if (auto it = versions.find(id); it != versions.end())
+    {
+        return it->second;
     }
+    stdplus::print(stderr, "Path: '{}' doesn't exist.\n", path);
+    return std::unexpected(::ipmi::ccInvalidFieldRequest);
+}
+
+std::vector<std::tuple<std::uint8_t, VersionTuple>> Handler::getCpldVersions()
+{
+    std::vector<std::tuple<std::uint8_t, VersionTuple>> versions;
+    for (const auto& [id, version] : cpldVersions())
+    {
+        if (id <= UINT8_MAX && version)
+        {
+            versions.emplace_back(id, *version);
+        }
+    }
+    return versions;
+}
 
-    return version;
+const std::map<unsigned int, Result<VersionTuple>>& Handler::cpldVersions()
+{
+    return _cpldVersions.get([this](auto& versions) {
+        versions.clear();
+        auto dir = getRunDir();
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            std::string name = entry.path().filename();
+            if (!name.starts_with("cpld") || !name.ends_with(".version"))
+            {
+                continue;
+            }
+
+            // Only the name getCpldVersion() would read, so not
+            // "cpld01.version".
+            auto id = parseInteger<unsigned int>(std::string_view(name).substr(
+                4, name.size() - 4 - std::string_view(".version").size()));
+            if (!id || entry.path() != cpldVersionPath(dir, *id))
+            {
+                continue;
+            }
+            versions.emplace(*id, readCpldVersion(entry.path()));
+        }
+    });
 }
 
-static constexpr auto TIME_DELAY_FILENAME = "/run/psu_timedelay";
+static constexpr auto TIME_DELAY_FILENAME = "psu_timedelay";
 static constexpr auto SYSTEMD_SERVICE = "org.freedesktop.systemd1";
 static constexpr auto SYSTEMD_ROOT = "/org/freedesktop/systemd1";
 static constexpr auto SYSTEMD_INTERFACE = "org.freedesktop.systemd1.Manager";
@@ -232,7 +491,7 @@ static constexpr auto PSU_HARDRESET_TARGET = "gbmc-psu-hardreset.target";
 void Handler::psuResetDelay(std::uint32_t delay) const
 {
     std::ofstream ofs;
-    ofs.open(TIME_DELAY_FILENAME, std::ofstream::out);
+    ofs.open(getRunDir() / TIME_DELAY_FILENAME, std::ofstream::out);
     if (!ofs.good())
     {
         stdplus::print(stderr, "Unable to open file for output.\n");
@@ -251,6 +510,7 @@ void Handler::psuResetDelay(std::uint32_t delay) const
     ofs.flush();
     ofs.close();
 
+    trace::DbusCallProbe probe("StartUnit");
     auto bus = sdbusplus::bus::new_default();
     auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
                                       SYSTEMD_INTERFACE, "StartUnit");
@@ -285,56 +545,198 @@ void Handler::psuResetOnShutdown() const
 
 uint32_t Handler::getFlashSize()
 {
-    mtd_info_t info;
-    int fd = open("/dev/mtd0", O_RDONLY);
-    int err = ioctl(fd, MEMGETINFO, &info);
-    close(fd);
+    auto partitions = getMtdPartitions();
+    if (!partitions)
+    {
+        throw IpmiException(partitions.error());
+    }
 
-    if (err)
+    auto mtd0 = std::ranges::find(*partitions, 0u, &MtdPartition::index);
+    if (mtd0 == partitions->end())
     {
+        stdplus::print(stderr, "No /dev/mtd0\n");
         throw IpmiException(::ipmi::ccUnspecifiedError);
     }
-    return info.size;
+    return mtd0->size;
+}
+
+Result<std::vector<MtdPartition>> Handler::getMtdPartitions()
+{
+    // Flash chips, such as the host SPI flash, are bound and unbound while
+    // running, so the kernel's mtd uevents mark the table stale.
+    const auto& partitions = _mtdPartitions.get([this](auto& partitions) {
+        trace::FileReadProbe probe("/proc/mtd");
+        auto read = readMtdPartitions();
+        if (!read)
+        {
+            stdplus::print(stderr, "Failed to read /proc/mtd: {}\n",
+                           std::strerror(read.error()));
+            probe.setCc(::ipmi::ccUnspecifiedError);
+            partitions.reset();
+            _mtdPartitions.invalidate();
+            return;
+        }
+        // An mtdN may now be another device, so its digest is of no use.
+        if (partitions && *partitions != *read)
+        {
+            _flashDigest.invalidate();
+        }
+        partitions = std::move(*read);
+    });
+    if (!partitions)
+    {
+        return std::unexpected(::ipmi::ccUnspecifiedError);
+    }
+    return *partitions;
 }
 
-std::string Handler::getEntityName(std::uint8_t id, std::uint8_t instance)
+Result<std::optional<Sha256>> Handler::getFlashDigest(std::uint8_t mtd,
+                                                      bool rescan)
+{
+    // A device that could not be opened before may be there now.
+    if (rescan)
+    {
+        _mtdPartitions.invalidate();
+    }
+    auto partitions = getMtdPartitions();
+    if (!partitions)
+    {
+        return std::unexpected(partitions.error());
+    }
+    auto partition = std::ranges::find(*partitions, mtd, &MtdPartition::index);
+    if (partition == partitions->end())
+    {
+        stdplus::print(stderr, "No /dev/mtd{}\n", mtd);
+        return std::unexpected(::ipmi::ccInvalidFieldRequest);
+    }
+
+    auto digest = _flashDigest.get(*partition, rescan);
+    if (!digest)
+    {
+        stdplus::print(stderr, "Failed to hash /dev/mtd{}: {}\n", mtd,
+                       std::strerror(digest.error()));
+        return std::unexpected(::ipmi::ccUnspecifiedError);
+    }
+    return *digest;
+}
+
+Result<std::string> Handler::getEntityName(std::uint8_t id,
+                                           std::uint8_t instance)
 {
     // Check if we support this Entity ID.
-    auto it = _entityIdToName.find(id);
-    if (it == _entityIdToName.end())
+    if (!entityTypeName(id))
     {
         log<level::ERR>("Unknown Entity ID", entry("ENTITY_ID=%d", id));
-        throw IpmiException(::ipmi::ccInvalidFieldRequest);
+        return std::unexpected(::ipmi::ccInvalidFieldRequest);
     }
 
-    std::string entityName;
-    try
+    auto index = getEntityNameIndex();
+    if (!index)
     {
-        // Parse the JSON config file.
-        if (!_entityConfigParsed)
+        return std::unexpected(index.error());
+    }
+
+    // Find the "entity id:entity instance" mapping to entity name.
+    auto entityName = (*index)->find(id, instance);
+    if (!entityName)
+    {
+        return std::unexpected(::ipmi::ccInvalidFieldRequest);
+    }
+
+    return std::string(*entityName);
+}
+
+Result<std::shared_ptr<const EntityNameIndex>> Handler::getEntityNameIndex()
+{
+    if (_entityManagerNames)
+    {
+        auto index = _entityManagerNames->index();
+        if (!index)
         {
-            _entityConfig = parseConfig(_configFile);
-            _entityConfigParsed = true;
+            // The first inventory snapshot has not arrived yet.
+            return std::unexpected(::ipmi::ccBusy);
         }
+        return index;
+    }
+
+#if STATIC_ENTITY_TABLE
+    // The image's own map was compiled in at build time; it cannot change.
+    if (_configFile == defaultConfigFile)
+    {
+        static const auto index = std::make_shared<const EntityNameIndex>(
+            generated::entityEntries, generated::entityNames);
+        return index;
+    }
+#endif
 
-        // Find the "entity id:entity instance" mapping to entity name.
-        entityName = readNameFromConfig(it->second, instance, _entityConfig);
-        if (entityName.empty())
+    // Load the index on first use and keep it current from then on. If the
+    // file cannot be watched, or its watch is dropped, try to watch it again
+    // on each call, and load it again once watched since it may have changed
+    // meanwhile. Until then, retry the load only while there is no index.
+    if (!_entityConfigLoaded)
+    {
+        _entityConfigLoaded = true;
+        watchEntityConfig();
+        reloadEntityConfig();
+    }
+    else if (!_entityConfigWatched)
+    {
+        if (watchEntityConfig() || !_entityIndex.load())
         {
-            throw IpmiException(::ipmi::ccInvalidFieldRequest);
+            reloadEntityConfig();
         }
     }
-    catch (InternalFailure& e)
+
+    auto index = _entityIndex.load();
+    if (!index)
     {
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return std::unexpected(::ipmi::ccUnspecifiedError);
     }
+    return index;
+}
 
-    return entityName;
+void Handler::useEntityManagerNames(
+    const std::shared_ptr<sdbusplus::asio::connection>& bus)
+{
+    _entityManagerNames = std::make_unique<EntityManagerNames>();
+    _entityManagerNames->start(bus);
+}
+
+bool Handler::watchEntityConfig()
+{
+    // Set first, so a drop reported before watch() returns is not lost.
+    _entityConfigWatched = true;
+    if (!_watcher.watch(
+            _configFile, [this]() { reloadEntityConfig(); },
+            [this]() { _entityConfigWatched = false; }))
+    {
+        _entityConfigWatched = false;
+        return false;
+    }
+    return true;
+}
+
+bool Handler::reloadEntityConfig()
+{
+    std::lock_guard guard(_entityReloadLock);
+    trace::FileReadProbe probe(_configFile.c_str());
+    try
+    {
+        _entityIndex.store(std::make_shared<const EntityNameIndex>(
+            parseConfig(_configFile)));
+    }
+    catch (InternalFailure& e)
+    {
+        probe.setCc(::ipmi::ccUnspecifiedError);
+        return false;
+    }
+    return true;
 }
 
 std::string Handler::getMachineName()
 {
     const char* path = "/etc/os-release";
+    trace::FileReadProbe probe(path);
     std::ifstream ifs(path);
     if (ifs.fail())
     {
@@ -373,14 +775,14 @@ std::string Handler::getMachineName()
     }
 }
 
-static constexpr auto HOST_TIME_DELAY_FILENAME = "/run/host_poweroff_delay";
+static constexpr auto HOST_TIME_DELAY_FILENAME = "host_poweroff_delay";
 static constexpr auto HOST_POWEROFF_TARGET = "gbmc-host-poweroff.target";
 
 void Handler::hostPowerOffDelay(std::uint32_t delay) const
 {
     // Set time delay
     std::ofstream ofs;
-    ofs.open(HOST_TIME_DELAY_FILENAME, std::ofstream::out);
+    ofs.open(getRunDir() / HOST_TIME_DELAY_FILENAME, std::ofstream::out);
     if (!ofs.good())
     {
         stdplus::print(stderr, "Unable to open file for output.\n");
@@ -396,6 +798,7 @@ void Handler::hostPowerOffDelay(std::uint32_t delay) const
     }
 
     // Write succeeded, please continue.
+    trace::DbusCallProbe probe("StartUnit");
     auto bus = sdbusplus::bus::new_default();
     auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
                                       SYSTEMD_INTERFACE, "StartUnit");
@@ -440,20 +843,51 @@ std::string readNameFromConfig(const std::string& type, uint8_t instance,
     return name;
 }
 
-void Handler::buildI2cPcieMapping()
+std::shared_ptr<const PcieSlotSnapshot> Handler::buildI2cPcieMapping()
 {
-    _pcie_i2c_map = buildPcieMap();
-}
+    const auto& snapshots = _pcieSnapshots.get([this](auto& snapshots) {
+        auto slots = buildPcieMap();
+        // Most i2c uevents are for client devices, not slots; keep the
+        // current generation rather than making hosts start over for nothing.
+        if (!snapshots.empty() && snapshots.back()->slots == slots)
+        {
+            return;
+        }
 
-size_t Handler::getI2cPcieMappingSize() const
-{
-    return _pcie_i2c_map.size();
+        if (++_pcieGeneration == 0)
+        {
+            _pcieGeneration = 1;
+        }
+        snapshots.push_back(std::make_shared<const PcieSlotSnapshot>(
+            PcieSlotSnapshot{_pcieGeneration, std::move(slots)}));
+        if (snapshots.size() > pcieSnapshotsKept)
+        {
+            snapshots.pop_front();
+        }
+    });
+    return snapshots.back();
 }
 
-std::tuple<std::uint32_t, std::string> Handler::getI2cEntry(
-    unsigned int entry) const
+std::shared_ptr<const PcieSlotSnapshot> Handler::getI2cPcieMapping(
+    std::uint8_t generation) const
 {
-    return _pcie_i2c_map[entry];
+    const auto& snapshots = _pcieSnapshots.last();
+    if (snapshots.empty())
+    {
+        return nullptr;
+    }
+    if (generation == 0)
+    {
+        return snapshots.back();
+    }
+    for (const auto& snapshot : snapshots)
+    {
+        if (snapshot->generation == generation)
+        {
+            return snapshot;
+        }
+    }
+    return nullptr;
 }
 
 namespace
@@ -483,12 +917,29 @@ const std::unique_ptr<FileSystemInterface>& Handler::getFs() const
     return this->fsPtr;
 }
 
-uint32_t Handler::accelOobDeviceCount() const
+const FileReaderInterface& Handler::getFileReader() const
+{
+    return _files;
+}
+
+fs::path Handler::getRunDir() const
+{
+    return "/run";
+}
+
+std::vector<std::string> Handler::getBmcModeFlagPaths() const
+{
+    return {bmDriveCleaningDoneAckFlagPath, bmDriveCleaningDoneFlagPath,
+            BM_SIGNAL_PATH};
+}
+
+Result<uint32_t> Handler::accelOobDeviceCount() const
 {
     ArrayOfObjectPathsAndTieredAnyTypeLists data;
 
     try
     {
+        trace::DbusCallProbe probe("GetManagedObjects");
         auto bus = getDbus();
         auto method = bus.new_method_call(ACCEL_OOB_SERVICE, "/",
                                           "org.freedesktop.DBus.ObjectManager",
@@ -500,18 +951,19 @@ uint32_t Handler::accelOobDeviceCount() const
         log<level::ERR>(
             "Failed to call GetManagedObjects on com.google.custom_accel",
             entry("WHAT=%s", ex.what()));
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return std::unexpected(::ipmi::ccUnspecifiedError);
     }
 
     return data.size();
 }
 
-std::string Handler::accelOobDeviceName(size_t index) const
+Result<std::string> Handler::accelOobDeviceName(size_t index) const
 {
     ArrayOfObjectPathsAndTieredAnyTypeLists data;
 
     try
     {
+        trace::DbusCallProbe probe("GetManagedObjects");
         auto bus = getDbus();
         auto method = bus.new_method_call(ACCEL_OOB_SERVICE, "/",
                                           "org.freedesktop.DBus.ObjectManager",
@@ -523,7 +975,7 @@ std::string Handler::accelOobDeviceName(size_t index) const
         log<level::ERR>(
             "Failed to call GetManagedObjects on com.google.custom_accel",
             entry("WHAT=%s", ex.what()));
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return std::unexpected(::ipmi::ccUnspecifiedError);
     }
 
     if (index >= data.size())
@@ -531,20 +983,20 @@ std::string Handler::accelOobDeviceName(size_t index) const
         log<level::WARNING>(
             "Requested index is larger than the number of entries.",
             entry("INDEX=%zu", index), entry("NUM_NAMES=%zu", data.size()));
-        throw IpmiException(::ipmi::ccParmOutOfRange);
+        return std::unexpected(::ipmi::ccParmOutOfRange);
     }
 
     std::string_view name(data[index].first.str);
     if (!name.starts_with(ACCEL_OOB_ROOT))
     {
-        throw IpmiException(::ipmi::ccInvalidCommand);
+        return std::unexpected(::ipmi::ccInvalidCommand);
     }
     name.remove_prefix(ACCEL_OOB_ROOT.length());
     return std::string(name);
 }
 
-uint64_t Handler::accelOobRead(std::string_view name, uint64_t address,
-                               uint8_t num_bytes) const
+Result<uint64_t> Handler::accelOobRead(std::string_view name, uint64_t address,
+                                       uint8_t num_bytes) const
 {
     static constexpr char ACCEL_OOB_METHOD[] = "Read";
 
@@ -560,6 +1012,7 @@ uint64_t Handler::accelOobRead(std::string_view name, uint64_t address,
 
     try
     {
+        trace::DbusCallProbe probe(ACCEL_OOB_METHOD);
         bus.call(method).read(bytes);
     }
     catch (const sdbusplus::exception::internal_exception& ex)
@@ -572,7 +1025,7 @@ uint64_t Handler::accelOobRead(std::string_view name, uint64_t address,
                         entry("DBUS_METHOD=%s", ACCEL_OOB_METHOD),
                         entry("DBUS_ARG_ADDRESS=%016llx", address),
                         entry("DBUS_ARG_NUM_BYTES=%zu", (size_t)num_bytes));
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return std::unexpected(::ipmi::ccUnspecifiedError);
     }
 
     if (bytes.size() < num_bytes)
@@ -587,7 +1040,7 @@ uint64_t Handler::accelOobRead(std::string_view name, uint64_t address,
             entry("DBUS_ARG_ADDRESS=%016llx", address),
             entry("DBUS_ARG_NUM_BYTES=%zu", (size_t)num_bytes),
             entry("DBUS_RETURN_SIZE=%zu", bytes.size()));
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return std::unexpected(::ipmi::ccUnspecifiedError);
     }
 
     if (bytes.size() > sizeof(uint64_t))
@@ -601,7 +1054,7 @@ uint64_t Handler::accelOobRead(std::string_view name, uint64_t address,
             entry("DBUS_ARG_ADDRESS=%016llx", address),
             entry("DBUS_ARG_NUM_BYTES=%zu", (size_t)num_bytes),
             entry("DBUS_RETURN_SIZE=%zu", bytes.size()));
-        throw IpmiException(::ipmi::ccReqDataTruncated);
+        return std::unexpected(::ipmi::ccReqDataTruncated);
     }
 
     uint64_t data = 0;
@@ -613,8 +1066,8 @@ uint64_t Handler::accelOobRead(std::string_view name, uint64_t address,
     return data;
 }
 
-void Handler::accelOobWrite(std::string_view name, uint64_t address,
-                            uint8_t num_bytes, uint64_t data) const
+Result<void> Handler::accelOobWrite(std::string_view name, uint64_t address,
+                                    uint8_t num_bytes, uint64_t data) const
 {
     static constexpr std::string_view ACCEL_OOB_METHOD = "Write";
 
@@ -632,7 +1085,7 @@ void Handler::accelOobWrite(std::string_view name, uint64_t address,
             entry("DBUS_ARG_ADDRESS=%016llx", address),
             entry("DBUS_ARG_NUM_BYTES=%zu", (size_t)num_bytes),
             entry("DBUS_ARG_DATA=%016llx", data));
-        throw IpmiException(::ipmi::ccParmOutOfRange);
+        return std::unexpected(::ipmi::ccParmOutOfRange);
     }
 
     std::vector<uint8_t> bytes;
@@ -645,6 +1098,7 @@ void Handler::accelOobWrite(std::string_view name, uint64_t address,
 
     try
     {
+        trace::DbusCallProbe probe(ACCEL_OOB_METHOD.data());
         auto bus = getDbus();
         auto method =
             bus.new_method_call(ACCEL_OOB_SERVICE, object_name.c_str(),
@@ -663,22 +1117,47 @@ void Handler::accelOobWrite(std::string_view name, uint64_t address,
                         entry("DBUS_ARG_ADDRESS=%016llx", address),
                         entry("DBUS_ARG_NUM_BYTES=%zu", (size_t)num_bytes),
                         entry("DBUS_ARG_DATA=%016llx", data));
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return std::unexpected(::ipmi::ccUnspecifiedError);
     }
+
+    return {};
+}
+
+void Handler::watchBifurcation()
+{
+#if DYNAMIC_BIFURCATION
+    // A slot's bus or PCI device may show up after the first lookup. The
+    // static backend notices changes to its file by itself.
+    if (!_bifurcationWatchTried)
+    {
+        _bifurcationWatchTried = true;
+        auto& bifurcation = bifurcationHelper.get();
+        auto changed = [&bifurcation]() { bifurcation.invalidate(); };
+        _uevents.watch("i2c", changed);
+        _uevents.watch("pci", changed);
+    }
+#endif
 }
 
 std::vector<uint8_t> Handler::pcieBifurcation(uint8_t index)
 {
+    watchBifurcation();
     return bifurcationHelper.get().getBifurcation(index).value_or(
         std::vector<uint8_t>{});
 }
 
+std::vector<std::tuple<std::uint8_t, std::vector<std::uint8_t>>>
+    Handler::pcieBifurcations()
+{
+    watchBifurcation();
+    return bifurcationHelper.get().getBifurcations();
+}
+
 static constexpr auto BARE_METAL_TARGET = "gbmc-bare-metal-active@0.target";
 
-void Handler::linuxBootDone() const
+void Handler::linuxBootDone()
 {
-    if (isBmcInBareMetalMode(this->fsPtr) !=
-        static_cast<uint8_t>(BmcMode::BM_MODE))
+    if (getBmcMode() != static_cast<uint8_t>(BmcMode::BM_MODE))
     {
         return;
     }
@@ -694,6 +1173,7 @@ void Handler::linuxBootDone() const
     log<level::INFO>("LinuxBootDone: Disabling IPMI");
 
     // Start the bare metal active systemd target.
+    trace::DbusCallProbe probe("StartUnit");
     auto bus = sdbusplus::bus::new_default();
     auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
                                       SYSTEMD_INTERFACE, "StartUnit");
@@ -719,8 +1199,9 @@ static constexpr char ACCEL_POWER_PATH_PREFIX[] =
     "/com/google/accelPower/accel_power_";
 static constexpr char POWER_MODE_IFC[] = "com.google.accelPower.Mode";
 
-void Handler::accelSetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
-                                 uint8_t settings_id, uint16_t value) const
+Result<void> Handler::accelSetVrSettings(::ipmi::Context::ptr ctx,
+                                         uint8_t chip_id, uint8_t settings_id,
+                                         uint16_t value) const
 {
     int vrSettingsReq;
     boost::system::error_code ec;
@@ -728,7 +1209,7 @@ void Handler::accelSetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
     {
         log<level::ERR>("Settings ID is not supported",
                         entry("settings_id=%d", settings_id));
-        throw IpmiException(::ipmi::ccParmOutOfRange);
+        return std::unexpected(::ipmi::ccParmOutOfRange);
     }
 
     vrSettingsReq = static_cast<int>(settings_id | value << 8);
@@ -736,15 +1217,21 @@ void Handler::accelSetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
         std::format("{}{}", ACCEL_POWER_PATH_PREFIX, chip_id));
 
     std::variant<int> val = vrSettingsReq;
-    ctx->bus->yield_method_call(
-        ctx->yield, ec, ACCEL_POWER_SERVICE, object_name.c_str(),
-        "org.freedesktop.DBus.Properties", "Set", POWER_MODE_IFC, "PowerMode",
-        val);
+    trace::DbusCallProbe probe("Set");
+    {
+        trace::SuspendScope suspend;
+        ctx->bus->yield_method_call(
+            ctx->yield, ec, ACCEL_POWER_SERVICE, object_name.c_str(),
+            "org.freedesktop.DBus.Properties", "Set", POWER_MODE_IFC,
+            "PowerMode", val);
+    }
     if (ec)
     {
         log<level::ERR>("Failed to set PowerMode property");
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
+
+    return {};
 }
 
 static constexpr char EXTERNAL_SENSOR_SERVICE[] =
@@ -753,35 +1240,88 @@ static constexpr char EXTERNAL_SENSOR_PATH_PREFIX[] =
     "/xyz/openbmc_project/sensors/power/";
 static constexpr char SENSOR_VALUE_IFC[] = "xyz.openbmc_project.Sensor.Value";
 
-uint16_t Handler::accelGetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
-                                     uint8_t settings_id) const
+Result<uint16_t> Handler::accelGetVrSettings(::ipmi::Context::ptr ctx,
+                                             uint8_t chip_id,
+                                             uint8_t settings_id) const
 {
     Value value;
     boost::system::error_code ec;
-    std::string object_name(
-        std::format("{}{}{}", EXTERNAL_SENSOR_PATH_PREFIX,
-                    _vrSettingsMap.at(settings_id), chip_id));
-
-    if (_vrSettingsMap.find(settings_id) == _vrSettingsMap.end())
+    auto setting = _vrSettingsMap.find(settings_id);
+    if (setting == _vrSettingsMap.end())
     {
         log<level::ERR>("Settings ID is not supported",
                         entry("settings_id=%d", settings_id));
-        throw IpmiException(::ipmi::ccParmOutOfRange);
+        return std::unexpected(::ipmi::ccParmOutOfRange);
     }
 
-    value = ctx->bus->yield_method_call<std::variant<double>>(
-        ctx->yield, ec, EXTERNAL_SENSOR_SERVICE, object_name.c_str(),
-        "org.freedesktop.DBus.Properties", "Get", SENSOR_VALUE_IFC, "Value");
+    std::string object_name(std::format("{}{}{}", EXTERNAL_SENSOR_PATH_PREFIX,
+                                        setting->second, chip_id));
+
+    trace::DbusCallProbe probe("Get");
+    {
+        trace::SuspendScope suspend;
+        value = ctx->bus->yield_method_call<std::variant<double>>(
+            ctx->yield, ec, EXTERNAL_SENSOR_SERVICE, object_name.c_str(),
+            "org.freedesktop.DBus.Properties", "Get", SENSOR_VALUE_IFC,
+            "Value");
+    }
     if (ec)
     {
         log<level::ERR>("accelGetVrSettings: Failed to call GetObject ");
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
 
     return static_cast<uint16_t>(std::get<double>(value));
 }
 
-std::string Handler::getBMInstanceProperty(uint8_t propertyType) const
+Result<std::string> Handler::getBMInstanceProperty(uint8_t propertyType)
+{
+    // Without a watch, read just the one file rather than all of them.
+    if (!_bmInstanceProperties.watched())
+    {
+        return readBMInstanceProperty(propertyType);
+    }
+
+    const auto& properties = bmInstanceProperties();
+    if (auto it = properties.find(propertyType); it != properties.end())
+    {
+        return it->second;
+    }
+    stdplus::print(stderr, "PropertyType: '{}' is invalid.\n", propertyType);
+    return std::unexpected(::ipmi::ccInvalidFieldRequest);
+}
+
+std::vector<std::tuple<uint8_t, std::string>>
+    Handler::getBMInstanceProperties(bool refresh)
+{
+    if (refresh || !_bmInstanceSnapshot)
+    {
+        std::vector<std::tuple<uint8_t, std::string>> properties;
+        for (const auto& [propertyType, property] : bmInstanceProperties())
+        {
+            if (property)
+            {
+                properties.emplace_back(propertyType, *property);
+            }
+        }
+        _bmInstanceSnapshot = std::move(properties);
+    }
+    return *_bmInstanceSnapshot;
+}
+
+const std::map<uint8_t, Result<std::string>>& Handler::bmInstanceProperties()
+{
+    return _bmInstanceProperties.get([this](auto& properties) {
+        properties.clear();
+        for (const auto& [propertyType, name] : bmInstanceTypeStringMap)
+        {
+            properties.emplace(propertyType,
+                               readBMInstanceProperty(propertyType));
+        }
+    });
+}
+
+Result<std::string> Handler::readBMInstanceProperty(uint8_t propertyType) const
 {
     std::string propertyTypeString;
     if (auto it = bmInstanceTypeStringMap.find(propertyType);
@@ -789,61 +1329,76 @@ std::string Handler::getBMInstanceProperty(uint8_t propertyType) const
     {
         stdplus::print(stderr, "PropertyType: '{}' is invalid.\n",
                        propertyType);
-        throw IpmiException(::ipmi::ccInvalidFieldRequest);
+        return std::unexpected(::ipmi::ccInvalidFieldRequest);
     }
     else
     {
         propertyTypeString = it->second;
     }
-    std::string opath = std::format("/run/bm-instance/{}", propertyTypeString);
-    // Check for file
+    std::string opath =
+        std::format("{}/{}", bmInstanceDir, propertyTypeString);
+    trace::FileReadProbe probe(opath.c_str());
 
-    std::error_code ec;
-    // TODO(brandonkim@google.com): Fix this to use stdplus::ManagedFd
-    if (!this->getFs()->exists(opath, ec))
+    std::array<char, 512> buf;
+    auto len = getFileReader().read(opath, buf);
+    if (!len)
     {
-        stdplus::print(stderr, "Path: '{}' doesn't exist.\n", opath);
-        throw IpmiException(::ipmi::ccInvalidFieldRequest);
+        if (len.error() == ENOENT)
+        {
+            stdplus::print(stderr, "Path: '{}' doesn't exist.\n", opath);
+            return probe.fail(::ipmi::ccInvalidFieldRequest);
+        }
+        stdplus::print(stderr, "Failed to read: '{}'.\n", opath);
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
-
-    std::ifstream ifs;
-    ifs.exceptions(std::ifstream::failbit);
-    std::string property;
-    try
+    if (*len == 0)
     {
-        ifs.open(opath);
-        std::getline(ifs, property);
+        stdplus::print(stderr, "Failed to read: '{}'.\n", opath);
+        return probe.fail(::ipmi::ccUnspecifiedError);
     }
-    catch (std::ios_base::failure& fail)
+
+    // A first line that does not fit in buf is read whole rather than cut.
+    std::string_view contents(buf.data(), *len);
+    std::string whole;
+    if (*len == buf.size() && contents.find('\n') == std::string_view::npos)
     {
-        stdplus::print(stderr, "Failed to read: '{}'.\n", opath);
-        throw IpmiException(::ipmi::ccUnspecifiedError);
+        auto all = getFileReader().readAll(opath);
+        if (!all)
+        {
+            stdplus::print(stderr, "Failed to read: '{}'.\n", opath);
+            return probe.fail(::ipmi::ccUnspecifiedError);
+        }
+        whole = std::move(*all);
+        contents = whole;
     }
 
-    return property;
+    return std::string(firstLine(contents));
 }
 
 std::optional<uint16_t> Handler::getCoreCount(const std::string& filePath) const
 {
-    std::error_code ec;
-    if (!this->getFs()->exists(filePath, ec))
-    {
-        log<level::INFO>("CPU config file not found",
-                         entry("PATH=%s", filePath.c_str()));
-        return std::nullopt;
-    }
+    trace::FileReadProbe probe(filePath.c_str());
+    probe.setCc(::ipmi::ccUnspecifiedError);
 
-    std::ifstream ifs(filePath);
-    if (!ifs.is_open())
+    auto contents = getFileReader().readAll(filePath);
+    if (!contents)
     {
-        log<level::ERR>("Failed to open CPU config file",
-                        entry("PATH=%s", filePath.c_str()));
+        if (contents.error() == ENOENT)
+        {
+            log<level::INFO>("CPU config file not found",
+                             entry("PATH=%s", filePath.c_str()));
+        }
+        else
+        {
+            log<level::ERR>("Failed to open CPU config file",
+                            entry("PATH=%s", filePath.c_str()));
+        }
         return std::nullopt;
     }
 
     try
     {
-        Json data = Json::parse(ifs);
+        Json data = Json::parse(*contents);
         if (data.contains("cpu_core_count") &&
             data["cpu_core_count"].is_number_integer())
         {
@@ -855,6 +1410,7 @@ std::optional<uint16_t> Handler::getCoreCount(const std::string& filePath) const
                                 entry("VALUE=%d", coreCountInt));
                 return std::nullopt;
             }
+            probe.setCc(::ipmi::ccSuccess);
             return static_cast<uint16_t>(coreCountInt);
         }
         else
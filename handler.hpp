@@ -14,11 +14,20 @@
 
 #pragma once
 
+#include "entity_index.hpp"
+#include "errors.hpp"
+#include "flash_digest.hpp"
+#include "link_stats.hpp"
+#include "mtd_partitions.hpp"
+#include "pcie_slot_snapshot.hpp"
+
 #include <ipmid/api-types.hpp>
 #include <ipmid/message.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
@@ -48,31 +57,72 @@ class HandlerInterface
      */
     virtual uint8_t getBmcMode() = 0;
 
+    /**
+     * Wait, without blocking other requests, for the BMC operation mode to
+     * change.
+     *
+     * @param[in] ctx - the IPMI context, to suspend the request on.
+     * @param[in] lastMode - the mode the caller last saw.
+     * @param[in] timeout - how long to wait for a different mode.
+     * @return the BMC operation mode, which is lastMode on timeout.
+     */
+    virtual uint8_t waitBmcModeChange(::ipmi::Context::ptr ctx,
+                                      uint8_t lastMode,
+                                      std::chrono::milliseconds timeout) = 0;
+
     /**
      * Return ethernet details (hard-coded).
      *
+     * @param[in] intf - the interface, or empty for the NCSI interface.
      * @return tuple of ethernet details (channel, if name).
      */
     virtual std::tuple<std::uint8_t, std::string> getEthDetails(
-        std::string intf) const = 0;
+        std::string_view intf) = 0;
+
+    /**
+     * Return every valid LAN channel of ipmid.
+     *
+     * @return (channel, if name) of each, in channel order.
+     */
+    virtual std::vector<std::tuple<std::uint8_t, std::string>>
+        getEthDevices() = 0;
 
     /**
      * Return the value of rx_packets, given a if_name.
      *
      * @param[in] name, the interface name.
-     * @return the number of packets received.
-     * @throw IpmiException on failure.
+     * @return the number of packets received, or the IPMI cc on failure.
+     */
+    virtual Result<std::int64_t> getRxPackets(
+        const std::string& name) const = 0;
+
+    /**
+     * Return the status of every interface but loopback, from one netlink
+     * dump.
+     *
+     * @param[in] refresh - dump the interfaces again and count deltas since
+     *                      the previous dump, rather than returning the
+     *                      previous dump.
+     * @return the interfaces, with the packets each moved between dumps.
      */
-    virtual std::int64_t getRxPackets(const std::string& name) const = 0;
+    virtual Result<std::vector<LinkStatus>> getLinkStatuses(bool refresh) = 0;
 
     /**
      * Return the values from a cpld version file.
      *
      * @param[in] id - the cpld id number.
-     * @return the quad of numbers as a tuple (maj,min,pt,subpt)
-     * @throw IpmiException on failure.
+     * @return the quad of numbers as a tuple (maj,min,pt,subpt), or the IPMI
+     *         cc on failure.
+     */
+    virtual Result<VersionTuple> getCpldVersion(unsigned int id) = 0;
+
+    /**
+     * Return the values of every valid cpld version file.
+     *
+     * @return (id, version) of each, in id order.
      */
-    virtual VersionTuple getCpldVersion(unsigned int id) const = 0;
+    virtual std::vector<std::tuple<std::uint8_t, VersionTuple>>
+        getCpldVersions() = 0;
 
     /**
      * Set the PSU Reset delay.
@@ -97,11 +147,21 @@ class HandlerInterface
      *
      * @param[in] id - the entity id value
      * @param[in] instance - the entity instance
-     * @return the entity's name
-     * @throw IpmiException on failure.
+     * @return the entity's name, or the IPMI cc on failure.
+     */
+    virtual Result<std::string> getEntityName(std::uint8_t id,
+                                              std::uint8_t instance) = 0;
+
+    /**
+     * Return the current entity name index, loading it on first use.
+     *
+     * The index is immutable; a reload publishes a new one, so callers can
+     * keep using what they were given.
+     *
+     * @return the index, or the IPMI cc on failure.
      */
-    virtual std::string getEntityName(std::uint8_t id,
-                                      std::uint8_t instance) = 0;
+    virtual Result<std::shared_ptr<const EntityNameIndex>>
+        getEntityNameIndex() = 0;
 
     /**
      * Return the flash size of bmc chip.
@@ -111,6 +171,26 @@ class HandlerInterface
      */
     virtual uint32_t getFlashSize() = 0;
 
+    /**
+     * Return the geometry of every MTD device of the bmc.
+     *
+     * @return the devices, in /proc/mtd order, or the IPMI cc on failure.
+     */
+    virtual Result<std::vector<MtdPartition>> getMtdPartitions() = 0;
+
+    /**
+     * Return the SHA-256 of an MTD device, hashed in the background.
+     *
+     * @param[in] mtd - N of the /dev/mtdN to hash.
+     * @param[in] rescan - forget the digests of every device first, unless
+     *                     this one is still being hashed or its digest has
+     *                     not been returned yet.
+     * @return the digest, std::nullopt while it is being worked out, or the
+     *         IPMI cc on failure.
+     */
+    virtual Result<std::optional<Sha256>> getFlashDigest(std::uint8_t mtd,
+                                                         bool rescan) = 0;
+
     /**
      * Return the name of the machine, parsed from release information.
      *
@@ -120,25 +200,23 @@ class HandlerInterface
     virtual std::string getMachineName() = 0;
 
     /**
-     * Populate the i2c-pcie mapping vector.
-     */
-    virtual void buildI2cPcieMapping() = 0;
-
-    /**
-     * Return the size of the i2c-pcie mapping vector.
+     * Rebuild the i2c-pcie mapping, if it may have changed since it was last
+     * built.
      *
-     * @return the size of the vector holding the i2c-pcie mapping tuples.
+     * @return the current snapshot.
      */
-    virtual size_t getI2cPcieMappingSize() const = 0;
+    virtual std::shared_ptr<const PcieSlotSnapshot> buildI2cPcieMapping() = 0;
 
     /**
-     * Return a copy of the entry in the vector.
+     * Return an i2c-pcie mapping snapshot built earlier.
      *
-     * @param[in] entry - the index into the vector.
-     * @return the tuple at that index.
+     * @param[in] generation - the snapshot's generation, or 0 for the current
+     *                         one.
+     * @return the snapshot, or nullptr if it was never built or has since
+     *         been dropped.
      */
-    virtual std::tuple<std::uint32_t, std::string> getI2cEntry(
-        unsigned int entry) const = 0;
+    virtual std::shared_ptr<const PcieSlotSnapshot> getI2cPcieMapping(
+        std::uint8_t generation) const = 0;
 
     /**
      * Set the Host Power Off delay.
@@ -151,10 +229,9 @@ class HandlerInterface
     /**
      * Return the number of devices from the CustomAccel service.
      *
-     * @return the number of devices.
-     * @throw IpmiException on failure.
+     * @return the number of devices, or the IPMI cc on failure.
      */
-    virtual uint32_t accelOobDeviceCount() const = 0;
+    virtual Result<uint32_t> accelOobDeviceCount() const = 0;
 
     /**
      * Return the name of a single device from the CustomAccel service.
@@ -163,10 +240,9 @@ class HandlerInterface
      * devices. The number of devices can be queried with accelOobDeviceCount.
      *
      * @param[in] index - the index of the device, starting at 0.
-     * @return the name of the device.
-     * @throw IpmiException on failure.
+     * @return the name of the device, or the IPMI cc on failure.
      */
-    virtual std::string accelOobDeviceName(size_t index) const = 0;
+    virtual Result<std::string> accelOobDeviceName(size_t index) const = 0;
 
     /**
      * Read from a single CustomAccel service device.
@@ -177,11 +253,12 @@ class HandlerInterface
      * @param[in] name - the name of the device (from DeviceName).
      * @param[in] address - the address to read from.
      * @param[in] num_bytes - the size of the read, in bytes.
-     * @return the data read, with 0s padding any unused MSBs.
-     * @throw IpmiException on failure.
+     * @return the data read, with 0s padding any unused MSBs, or the IPMI cc
+     *         on failure.
      */
-    virtual uint64_t accelOobRead(std::string_view name, uint64_t address,
-                                  uint8_t num_bytes) const = 0;
+    virtual Result<uint64_t> accelOobRead(std::string_view name,
+                                          uint64_t address,
+                                          uint8_t num_bytes) const = 0;
 
     /**
      * Write to a single CustomAccel service device.
@@ -193,10 +270,11 @@ class HandlerInterface
      * @param[in] address - the address to read from.
      * @param[in] num_bytes - the size of the read, in bytes.
      * @param[in] data - the data to write.
-     * @throw IpmiException on failure.
+     * @return nothing, or the IPMI cc on failure.
      */
-    virtual void accelOobWrite(std::string_view name, uint64_t address,
-                               uint8_t num_bytes, uint64_t data) const = 0;
+    virtual Result<void> accelOobWrite(std::string_view name, uint64_t address,
+                                       uint8_t num_bytes,
+                                       uint64_t data) const = 0;
 
     /**
      * Parse the I2C tree to get the highest level of bifurcation in target bus.
@@ -206,13 +284,21 @@ class HandlerInterface
      */
     virtual std::vector<uint8_t> pcieBifurcation(uint8_t index) = 0;
 
+    /**
+     * Get the bifurcation of every configured PCIe slot.
+     *
+     * @return (index, lanes) for each slot, in index order.
+     */
+    virtual std::vector<std::tuple<std::uint8_t, std::vector<std::uint8_t>>>
+        pcieBifurcations() = 0;
+
     /**
      * Prepare for OS boot.
      *
      * If in bare metal mode, the BMC will disable IPMI, to protect against an
      * untrusted OS.
      */
-    virtual void linuxBootDone() const = 0;
+    virtual void linuxBootDone() = 0;
 
     /**
      * Update the VR settings for the given settings_id
@@ -220,28 +306,43 @@ class HandlerInterface
      * @param[in] chip_id    - Accel Device#
      * @param[in] settings_id  - ID of the setting to update
      * @param[in] value  - Value of the setting
+     * @return nothing, or the IPMI cc on failure.
      */
-    virtual void accelSetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
-                                    uint8_t settings_id,
-                                    uint16_t value) const = 0;
+    virtual Result<void> accelSetVrSettings(::ipmi::Context::ptr ctx,
+                                            uint8_t chip_id,
+                                            uint8_t settings_id,
+                                            uint16_t value) const = 0;
 
     /**
      * Read current VR settings value for the given settings_id
      *
      * @param[in] chip_id    - Accel Device#
      * @param[in] settings_id  - ID of the setting to read
+     * @return the setting's value, or the IPMI cc on failure.
      */
-    virtual uint16_t accelGetVrSettings(::ipmi::Context::ptr ctx,
-                                        uint8_t chip_id,
-                                        uint8_t settings_id) const = 0;
+    virtual Result<uint16_t> accelGetVrSettings(::ipmi::Context::ptr ctx,
+                                                uint8_t chip_id,
+                                                uint8_t settings_id) const = 0;
 
     /**
      * Get the BM instance property from /run/<propertyType>
      *
      * @param[in] propertyType  - BM instance property type
-     * @return - string of the requested BM instance property
+     * @return - string of the requested BM instance property, or the IPMI cc
+     *           on failure.
+     */
+    virtual Result<std::string> getBMInstanceProperty(
+        uint8_t propertyType) = 0;
+
+    /**
+     * Get every BM instance property that can be read.
+     *
+     * @param[in] refresh - take the current values; otherwise return the
+     *                      values of the last refresh.
+     * @return (propertyType, property) of each, in type order.
      */
-    virtual std::string getBMInstanceProperty(uint8_t propertyType) const = 0;
+    virtual std::vector<std::tuple<uint8_t, std::string>>
+        getBMInstanceProperties(bool refresh) = 0;
 
     /**
      * Return the number of CPU cores.
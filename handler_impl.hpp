@@ -15,19 +15,37 @@
 #pragma once
 
 #include "bifurcation.hpp"
+#include "bm_config.h"
+#include "bmc_mode_enum.hpp"
+#include "cached_file_reader.hpp"
+#include "entity_index.hpp"
+#include "entity_manager_names.hpp"
 #include "file_system_wrapper_impl.hpp"
 #include "handler.hpp"
+#include "inotify_watcher.hpp"
+#include "uevent_monitor.hpp"
+#include "watched_cache.hpp"
 
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <nlohmann/json.hpp>
+#include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/bus.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <format>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace google
@@ -38,13 +56,16 @@ namespace ipmi
 constexpr char defaultConfigFile[] =
     "/usr/share/ipmi-entity-association/entity_association_map.json";
 
+// Where the BM instance property files are, named by bmInstanceTypeStringMap.
+constexpr char bmInstanceDir[] = "/run/bm-instance";
+
 class Handler : public HandlerInterface
 {
   public:
     explicit Handler(const std::string& entityConfigPath = defaultConfigFile) :
         fsPtr(std::make_unique<FileSystemWrapper>()),
         _configFile(entityConfigPath),
-        bifurcationHelper(BifurcationStatic::createBifurcation()) {};
+        bifurcationHelper(createBifurcation()) {};
     Handler(std::reference_wrapper<BifurcationInterface> bifurcationHelper,
             const std::string& entityConfigPath = defaultConfigFile) :
         fsPtr(std::make_unique<FileSystemWrapper>()),
@@ -52,63 +73,133 @@ class Handler : public HandlerInterface
     ~Handler() = default;
 
     uint8_t getBmcMode() override;
+    uint8_t waitBmcModeChange(::ipmi::Context::ptr ctx, uint8_t lastMode,
+                              std::chrono::milliseconds timeout) override;
     std::tuple<std::uint8_t, std::string> getEthDetails(
-        std::string intf) const override;
-    std::int64_t getRxPackets(const std::string& name) const override;
-    VersionTuple getCpldVersion(unsigned int id) const override;
+        std::string_view intf) override;
+    std::vector<std::tuple<std::uint8_t, std::string>> getEthDevices()
+        override;
+    Result<std::int64_t> getRxPackets(const std::string& name) const override;
+    Result<std::vector<LinkStatus>> getLinkStatuses(bool refresh) override;
+    Result<VersionTuple> getCpldVersion(unsigned int id) override;
+    std::vector<std::tuple<std::uint8_t, VersionTuple>> getCpldVersions()
+        override;
     void psuResetDelay(std::uint32_t delay) const override;
     void psuResetOnShutdown() const override;
-    std::string getEntityName(std::uint8_t id, std::uint8_t instance) override;
+    Result<std::string> getEntityName(std::uint8_t id,
+                                      std::uint8_t instance) override;
+    Result<std::shared_ptr<const EntityNameIndex>> getEntityNameIndex()
+        override;
     uint32_t getFlashSize() override;
+    Result<std::vector<MtdPartition>> getMtdPartitions() override;
+    Result<std::optional<Sha256>> getFlashDigest(std::uint8_t mtd,
+                                                 bool rescan) override;
     std::string getMachineName() override;
-    void buildI2cPcieMapping() override;
-    size_t getI2cPcieMappingSize() const override;
+    std::shared_ptr<const PcieSlotSnapshot> buildI2cPcieMapping() override;
+    std::shared_ptr<const PcieSlotSnapshot> getI2cPcieMapping(
+        std::uint8_t generation) const override;
     void hostPowerOffDelay(std::uint32_t delay) const override;
-    std::tuple<std::uint32_t, std::string> getI2cEntry(
-        unsigned int entry) const override;
     std::vector<uint8_t> pcieBifurcation(uint8_t) override;
+    std::vector<std::tuple<std::uint8_t, std::vector<std::uint8_t>>>
+        pcieBifurcations() override;
 
-    uint32_t accelOobDeviceCount() const override;
-    std::string accelOobDeviceName(size_t index) const override;
-    uint64_t accelOobRead(std::string_view name, uint64_t address,
-                          uint8_t num_bytes) const override;
-    void accelOobWrite(std::string_view name, uint64_t address,
-                       uint8_t num_bytes, uint64_t data) const override;
-    void linuxBootDone() const override;
-    void accelSetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
-                            uint8_t settings_id, uint16_t value) const override;
-    uint16_t accelGetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
-                                uint8_t settings_id) const override;
-    std::string getBMInstanceProperty(uint8_t propertyType) const override;
+    Result<uint32_t> accelOobDeviceCount() const override;
+    Result<std::string> accelOobDeviceName(size_t index) const override;
+    Result<uint64_t> accelOobRead(std::string_view name, uint64_t address,
+                                  uint8_t num_bytes) const override;
+    Result<void> accelOobWrite(std::string_view name, uint64_t address,
+                               uint8_t num_bytes, uint64_t data) const override;
+    void linuxBootDone() override;
+    Result<void> accelSetVrSettings(::ipmi::Context::ptr ctx, uint8_t chip_id,
+                                    uint8_t settings_id,
+                                    uint16_t value) const override;
+    Result<uint16_t> accelGetVrSettings(::ipmi::Context::ptr ctx,
+                                        uint8_t chip_id,
+                                        uint8_t settings_id) const override;
+    Result<std::string> getBMInstanceProperty(uint8_t propertyType) override;
+    std::vector<std::tuple<uint8_t, std::string>> getBMInstanceProperties(
+        bool refresh) override;
     std::optional<uint16_t> getCoreCount(
         const std::string& filePath) const override;
 
+    /**
+     * Serve entity names from the Entity Manager inventory instead of the
+     * entity association map.
+     *
+     * @param[in] bus - the connection to read and watch the inventory on.
+     */
+    void useEntityManagerNames(
+        const std::shared_ptr<sdbusplus::asio::connection>& bus);
+
   protected:
     // Exposed for dependency injection
     virtual sdbusplus::bus_t getDbus() const;
     virtual const std::unique_ptr<FileSystemInterface>& getFs() const;
+    // Reads the files that are polled, such as rx_packets and the CPLD
+    // versions.
+    virtual const FileReaderInterface& getFileReader() const;
+    // The directory the power paths leave their delay files in, and the
+    // CPLD version files are in, as cpld<id>.version.
+    virtual fs::path getRunDir() const;
+    // The flag files whose changes may change the BMC mode.
+    virtual std::vector<std::string> getBmcModeFlagPaths() const;
+
+    /** waitBmcModeChange(), waiting on io in the coroutine of yield. */
+    uint8_t waitBmcModeChange(boost::asio::io_context& io,
+                              boost::asio::yield_context yield,
+                              uint8_t lastMode,
+                              std::chrono::milliseconds timeout);
 
   private:
+    /**
+     * Parse the entity association map and publish a new index for it. The
+     * current index is kept if the file cannot be parsed.
+     *
+     * @return true if a new index was published.
+     */
+    bool reloadEntityConfig();
+
+    /**
+     * Watch the entity association map for changes.
+     *
+     * @return true if the watch was added.
+     */
+    bool watchEntityConfig();
+
+    /** The valid LAN channels that ipmid reports, in channel order. */
+    const std::vector<std::tuple<std::uint8_t, std::string>>& ethChannels();
+
+    /**
+     * Every cpld version file, by id, read again only after one of them
+     * changes.
+     */
+    const std::map<unsigned int, Result<VersionTuple>>& cpldVersions();
+
+    /** Invalidate the bifurcation helper on i2c and pci uevents. */
+    void watchBifurcation();
+
+    /** Wake the requests waiting in waitBmcModeChange(). */
+    void wakeBmcModeWaiters();
+
+    /** Read and parse one cpld version file. */
+    Result<VersionTuple> readCpldVersion(const std::string& path) const;
+
+    /**
+     * Every BM instance property, by type, read again only after one of the
+     * files changes.
+     */
+    const std::map<uint8_t, Result<std::string>>& bmInstanceProperties();
+
+    /** Read one BM instance property file. */
+    Result<std::string> readBMInstanceProperty(uint8_t propertyType) const;
+
     std::unique_ptr<FileSystemInterface> fsPtr;
 
     std::string _configFile;
 
-    bool _entityConfigParsed = false;
-
-    const std::map<uint8_t, std::string> _entityIdToName{
-        {0x03, "cpu"},
-        {0x04, "storage_device"},
-        {0x06, "system_management_module"},
-        {0x07, "system_board"},
-        {0x08, "memory_module"},
-        {0x0B, "add_in_card"},
-        {0x0E, "power_system_board"},
-        {0x10, "system_internal_expansion_board"},
-        {0x11, "other_system_board"},
-        {0x17, "system_chassis"},
-        {0x1D, "fan"},
-        {0x1E, "cooling_unit"},
-        {0x20, "memory_device"}};
+    bool _entityConfigLoaded = false;
+    // Cleared on the watcher thread when the watch is dropped.
+    std::atomic<bool> _entityConfigWatched = false;
 
     const std::unordered_map<uint8_t, std::string> _vrSettingsMap{
         {0, "idle_mode_"},     {1, "power_brake_"},
@@ -121,11 +212,77 @@ class Handler : public HandlerInterface
         {0x04, "sku"},       {0x05, "system-serial-number"},
         {0x06, "uuid"}};
 
-    nlohmann::json _entityConfig{};
+    // Swapped whole by reloadEntityConfig() so readers never take a lock.
+    std::atomic<std::shared_ptr<const EntityNameIndex>> _entityIndex;
+    std::mutex _entityReloadLock;
+    std::unique_ptr<EntityManagerNames> _entityManagerNames;
 
-    std::vector<std::tuple<uint32_t, std::string>> _pcie_i2c_map;
+    // The last few snapshots, oldest first, so a host still paging through
+    // one when it is replaced can finish.
+    static constexpr size_t pcieSnapshotsKept = 4;
+    // Scanned again when an i2c device comes or goes.
+    WatchedCache<std::deque<std::shared_ptr<const PcieSlotSnapshot>>>
+        _pcieSnapshots{_uevents, "i2c"};
+    std::uint8_t _pcieGeneration = 0;
 
     std::reference_wrapper<BifurcationInterface> bifurcationHelper;
+    // With the dynamic backend, the helper is invalidated on i2c and pci
+    // uevents from the first lookup.
+    bool _bifurcationWatchTried = false;
+
+    // Built on first use from ipmid's channel table.
+    std::optional<std::vector<std::tuple<std::uint8_t, std::string>>>
+        _ethChannels;
+
+    // Read again when a cpld version file is written, added or removed.
+    WatchedCache<std::map<unsigned int, Result<VersionTuple>>> _cpldVersions{
+        _watcher, [this]() {
+            return std::vector<std::string>{getRunDir() / "cpld*.version"};
+        }};
+
+    // Read again when an mtd device is added or removed, or the host asks
+    // for a flash digest rescan.
+    WatchedCache<std::optional<std::vector<MtdPartition>>> _mtdPartitions{
+        _uevents, "mtd"};
+
+    // Read again when a BM instance property file is written, added or
+    // removed.
+    WatchedCache<std::map<uint8_t, Result<std::string>>> _bmInstanceProperties{
+        _watcher, {std::format("{}/*", bmInstanceDir)}};
+    // The values of the last refresh, for the rest of a fragmented reply.
+    std::optional<std::vector<std::tuple<uint8_t, std::string>>>
+        _bmInstanceSnapshot;
+
+    // Keeps the files read on every poll open between requests.
+    CachedFileReader _files;
+
+    // The last interface dump, for later pages, and its counters by
+    // interface index, to count the next dump's deltas from.
+    std::optional<std::vector<LinkStatus>> _linkStatuses;
+    std::unordered_map<int, std::tuple<std::uint64_t, std::uint64_t>>
+        _linkCounters;
+
+    // Whether getBmcMode() has logged a mode yet.
+    bool _bmcModeReported = false;
+    // Worked out again when a bare metal flag file changes, which also wakes
+    // the requests waiting for a change.
+    WatchedCache<std::uint8_t> _bmcMode{
+        _watcher, [this]() { return getBmcModeFlagPaths(); },
+        [this]() { wakeBmcModeWaiters(); }};
+    // Timers of requests waiting in waitBmcModeChange(); a flag file change
+    // cancels them to wake the requests. Past the limit, further requests
+    // are answered at once instead of being held too.
+    static constexpr size_t maxBmcModeWaiters = 8;
+    std::mutex _bmcModeWaitLock;
+    std::vector<std::shared_ptr<boost::asio::steady_timer>> _bmcModeWaiters;
+
+    // Kept until the host asks for a rescan.
+    FlashDigest _flashDigest;
+
+    // Last, so the watcher threads are stopped before anything they update is
+    // destroyed.
+    InotifyWatcher _watcher;
+    UeventMonitor _uevents;
 };
 
 /**
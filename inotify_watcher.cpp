@@ -0,0 +1,216 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "inotify_watcher.hpp"
+
+#include <fnmatch.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <stdplus/print.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+InotifyWatcher::~InotifyWatcher()
+{
+    if (thread.joinable())
+    {
+        std::uint64_t one = 1;
+        if (::write(stopFd.get(), &one, sizeof(one)) < 0)
+        {
+            stdplus::print(stderr, "Failed to stop inotify watcher: {}\n",
+                           std::strerror(errno));
+        }
+        thread.join();
+    }
+}
+
+bool InotifyWatcher::start()
+{
+    if (inotifyFd.get() < 0)
+    {
+        inotifyFd.reset(inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+        if (inotifyFd.get() < 0)
+        {
+            stdplus::print(stderr, "inotify_init1 failed: {}\n",
+                           std::strerror(errno));
+            return false;
+        }
+    }
+    if (stopFd.get() < 0)
+    {
+        stopFd.reset(eventfd(0, EFD_CLOEXEC));
+        if (stopFd.get() < 0)
+        {
+            stdplus::print(stderr, "eventfd failed: {}\n",
+                           std::strerror(errno));
+            return false;
+        }
+    }
+    if (!thread.joinable())
+    {
+        thread = std::thread(&InotifyWatcher::run, this);
+    }
+    return true;
+}
+
+bool InotifyWatcher::watch(const std::string& path, Callback callback,
+                           Callback lost)
+{
+    std::filesystem::path file(path);
+    std::string dir = file.parent_path();
+    if (dir.empty())
+    {
+        dir = ".";
+    }
+
+    std::lock_guard guard(lock);
+    if (!start())
+    {
+        return false;
+    }
+
+    int wd = inotify_add_watch(
+        inotifyFd.get(), dir.c_str(),
+        IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+    if (wd < 0)
+    {
+        stdplus::print(stderr, "Failed to watch '{}': {}\n", dir,
+                       std::strerror(errno));
+        return false;
+    }
+
+    watches.push_back(Watch{nextId++, wd, file.filename(), std::move(callback),
+                            std::move(lost)});
+    return true;
+}
+
+void InotifyWatcher::run()
+{
+    alignas(inotify_event) std::array<char, 4096> buf;
+    std::array<pollfd, 2> fds{
+        {{stopFd.get(), POLLIN, 0}, {inotifyFd.get(), POLLIN, 0}}};
+
+    while (true)
+    {
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            stdplus::print(stderr, "inotify watcher poll failed: {}\n",
+                           std::strerror(errno));
+            return;
+        }
+        if (fds[0].revents)
+        {
+            return;
+        }
+
+        // Gather the whole batch first, so a file that was touched several
+        // times is only handled once.
+        std::vector<std::size_t> pending;
+        std::vector<Callback> callbacks;
+        bool overflow = false;
+        ssize_t len;
+        while ((len = ::read(inotifyFd.get(), buf.data(), buf.size())) > 0)
+        {
+            std::lock_guard guard(lock);
+            for (char* p = buf.data(); p < buf.data() + len;)
+            {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    overflow = true;
+                    continue;
+                }
+                // The directory was deleted or unmounted and the kernel has
+                // removed its watch; the descriptor may be reused.
+                if (event->mask & IN_IGNORED)
+                {
+                    for (const auto& w : watches)
+                    {
+                        if (w.wd == event->wd)
+                        {
+                            callbacks.push_back(w.callback);
+                            if (w.lost)
+                            {
+                                callbacks.push_back(w.lost);
+                            }
+                        }
+                    }
+                    std::erase_if(watches, [&](const Watch& w) {
+                        return w.wd == event->wd;
+                    });
+                    continue;
+                }
+                if (event->len == 0)
+                {
+                    continue;
+                }
+                for (const auto& w : watches)
+                {
+                    if (w.wd == event->wd &&
+                        ::fnmatch(w.name.c_str(), event->name, 0) == 0 &&
+                        std::find(pending.begin(), pending.end(), w.id) ==
+                            pending.end())
+                    {
+                        pending.push_back(w.id);
+                    }
+                }
+            }
+        }
+
+        // Callbacks run without the lock so they may add watches.
+        {
+            std::lock_guard guard(lock);
+            for (const auto& w : watches)
+            {
+                if (overflow || std::find(pending.begin(), pending.end(),
+                                          w.id) != pending.end())
+                {
+                    callbacks.push_back(w.callback);
+                }
+            }
+        }
+        for (const auto& cb : callbacks)
+        {
+            cb();
+        }
+    }
+}
+
+} // namespace ipmi
+} // namespace google
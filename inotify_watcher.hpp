@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "scoped_fd.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * Runs callbacks when watched files are rewritten.
+ *
+ * The parent directory of each file is watched rather than the file itself,
+ * so replacing a file by renaming over it is seen as well as writing it in
+ * place. All watches share one inotify descriptor and one thread, started by
+ * the first successful watch() and stopped by the destructor.
+ */
+class InotifyWatcher
+{
+  public:
+    using Callback = std::function<void()>;
+
+    InotifyWatcher() = default;
+    ~InotifyWatcher();
+
+    InotifyWatcher(const InotifyWatcher&) = delete;
+    InotifyWatcher& operator=(const InotifyWatcher&) = delete;
+
+    /**
+     * Call callback, on the watcher thread, whenever path is created, closed
+     * after writing, moved onto, moved away or deleted. If the kernel drops
+     * events, every callback is called.
+     *
+     * The file name may be a shell wildcard pattern, as fnmatch(3), to watch
+     * every matching file of the directory, such as "/run/cpld*.version".
+     *
+     * If the directory itself is deleted or unmounted, the watch is dropped:
+     * callback is called one last time and then lost, so the owner can stop
+     * trusting what it cached and call watch() again.
+     *
+     * @param[in] path - the file to watch; its directory must exist.
+     * @param[in] callback - the function to call.
+     * @param[in] lost - the function to call when the watch is dropped.
+     * @return true if the watch was added.
+     */
+    bool watch(const std::string& path, Callback callback,
+               Callback lost = nullptr);
+
+  private:
+    struct Watch
+    {
+        std::size_t id;
+        int wd;
+        std::string name;
+        Callback callback;
+        Callback lost;
+    };
+
+    bool start();
+    void run();
+
+    std::mutex lock;
+    std::vector<Watch> watches;
+    std::size_t nextId = 0;
+    ScopedFd inotifyFd;
+    ScopedFd stopFd;
+    std::thread thread;
+};
+
+} // namespace ipmi
+} // namespace google
@@ -32,6 +32,7 @@
 #include "pcie_bifurcation.hpp"
 #include "pcie_i2c.hpp"
 #include "psu.hpp"
+#include "tracing.hpp"
 
 #include <ipmid/api.h>
 
@@ -49,33 +50,56 @@ namespace google
 namespace ipmi
 {
 
-Resp handleSysCommand(HandlerInterface* handler, ::ipmi::Context::ptr ctx,
-                      uint8_t cmd, std::span<const uint8_t> data)
+namespace
+{
+
+Resp dispatchSysCommand(HandlerInterface* handler, ::ipmi::Context::ptr ctx,
+                        uint8_t cmd, std::span<const uint8_t> data)
 {
     switch (cmd)
     {
         case SysGetBmcMode:
             return getBmcMode(data, handler);
+        case SysWaitBmcModeChange:
+            return waitBmcModeChange(ctx, data, handler);
         case SysCableCheck:
             return cableCheck(data, handler);
+        case SysCableCheckAll:
+            return cableCheckAll(data, handler);
         case SysCpldVersion:
             return cpldVersion(data, handler);
+        case SysCpldVersions:
+            return cpldVersions(data, handler);
         case SysGetEthDevice:
             return getEthDevice(data, handler);
+        case SysGetEthDevices:
+            return getEthDevices(data, handler);
         case SysPsuHardReset:
             return psuHardReset(data, handler);
         case SysPcieSlotCount:
             return pcieSlotCount(data, handler);
         case SysPcieSlotI2cBusMapping:
             return pcieSlotI2cBusMapping(data, handler);
+        case SysPcieSlotI2cBusMappingList:
+            return pcieSlotI2cBusMappingList(data, handler);
+        case SysPcieSlotByName:
+            return pcieSlotByName(data, handler);
+        case SysPcieSlotByBus:
+            return pcieSlotByBus(data, handler);
         case SysEntityName:
             return getEntityName(data, handler);
+        case SysEntityNameList:
+            return getEntityNameList(data, handler);
         case SysMachineName:
             return getMachineName(data, handler);
         case SysPsuHardResetOnShutdown:
             return psuHardResetOnShutdown(data, handler);
         case SysGetFlashSize:
             return getFlashSize(data, handler);
+        case SysMtdPartitions:
+            return mtdPartitions(data, handler);
+        case SysFlashFullDigest:
+            return flashDigest(data, handler);
         case SysHostPowerOff:
             return hostPowerOff(data, handler);
         case SysAccelOobDeviceCount:
@@ -88,6 +112,8 @@ Resp handleSysCommand(HandlerInterface* handler, ::ipmi::Context::ptr ctx,
             return accelOobWrite(data, handler);
         case SysPCIeSlotBifurcation:
             return pcieBifurcation(data, handler);
+        case SysPCIeSlotBifurcationList:
+            return pcieBifurcationList(data, handler);
         case SysLinuxBootDone:
             return linuxBootDone(data, handler);
         case SysGetAccelVrSettings:
@@ -96,6 +122,8 @@ Resp handleSysCommand(HandlerInterface* handler, ::ipmi::Context::ptr ctx,
             return accelSetVrSettings(ctx, data, handler);
         case SysGetBMInstanceProperty:
             return getBMInstanceProperty(data, handler);
+        case SysGetBMInstanceProperties:
+            return getBMInstanceProperties(data, handler);
         case SysReadBiosSetting:
             return readBiosSetting(data, handler);
         case SysWriteBiosSetting:
@@ -108,5 +136,16 @@ Resp handleSysCommand(HandlerInterface* handler, ::ipmi::Context::ptr ctx,
     }
 }
 
+} // namespace
+
+Resp handleSysCommand(HandlerInterface* handler, ::ipmi::Context::ptr ctx,
+                      uint8_t cmd, std::span<const uint8_t> data)
+{
+    trace::CommandProbe probe(cmd, data.size());
+    Resp resp = dispatchSysCommand(handler, ctx, cmd, data);
+    probe.setCc(std::get<0>(resp));
+    return resp;
+}
+
 } // namespace ipmi
 } // namespace google
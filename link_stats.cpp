@@ -0,0 +1,189 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "link_stats.hpp"
+
+#include "scoped_fd.hpp"
+
+#include <linux/if.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace
+{
+
+// Copy an attribute's payload out, as it may not be aligned for T.
+template <typename T>
+std::optional<T> attributeAs(const rtattr* attr)
+{
+    if (RTA_PAYLOAD(attr) < sizeof(T))
+    {
+        return std::nullopt;
+    }
+    T value;
+    std::memcpy(&value, RTA_DATA(attr), sizeof(T));
+    return value;
+}
+
+} // namespace
+
+std::optional<LinkStats> parseLinkMessage(const nlmsghdr* message)
+{
+    if (message->nlmsg_type != RTM_NEWLINK ||
+        message->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg)))
+    {
+        return std::nullopt;
+    }
+
+    const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(message));
+    LinkStats link{};
+    link.index = info->ifi_index;
+    link.flags = info->ifi_flags;
+
+    bool haveStats64 = false;
+    int len = message->nlmsg_len - NLMSG_LENGTH(sizeof(*info));
+    for (const auto* attr = IFLA_RTA(info); RTA_OK(attr, len);
+         attr = RTA_NEXT(attr, len))
+    {
+        switch (attr->rta_type)
+        {
+            case IFLA_IFNAME:
+            {
+                const auto* name = static_cast<const char*>(RTA_DATA(attr));
+                link.name.assign(name, strnlen(name, RTA_PAYLOAD(attr)));
+                break;
+            }
+            case IFLA_OPERSTATE:
+                link.operState =
+                    attributeAs<std::uint8_t>(attr).value_or(IF_OPER_UNKNOWN);
+                break;
+            case IFLA_STATS64:
+                if (auto stats = attributeAs<rtnl_link_stats64>(attr))
+                {
+                    link.rxPackets = stats->rx_packets;
+                    link.txPackets = stats->tx_packets;
+                    haveStats64 = true;
+                }
+                break;
+            case IFLA_STATS:
+                if (auto stats = attributeAs<rtnl_link_stats>(attr);
+                    stats && !haveStats64)
+                {
+                    link.rxPackets = stats->rx_packets;
+                    link.txPackets = stats->tx_packets;
+                }
+                break;
+        }
+    }
+
+    if (link.name.empty())
+    {
+        return std::nullopt;
+    }
+    return link;
+}
+
+std::expected<std::vector<LinkStats>, int> dumpLinkStats()
+{
+    ScopedFd fd(::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE));
+    if (fd.get() < 0)
+    {
+        return std::unexpected(errno);
+    }
+
+    struct
+    {
+        nlmsghdr header;
+        ifinfomsg info;
+    } request{};
+    request.header.nlmsg_len = sizeof(request);
+    request.header.nlmsg_type = RTM_GETLINK;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = 1;
+    request.info.ifi_family = AF_UNSPEC;
+
+    if (::send(fd.get(), &request, sizeof(request), 0) < 0)
+    {
+        return std::unexpected(errno);
+    }
+
+    std::vector<LinkStats> links;
+    // On the heap, as handlers may run on a small coroutine stack.
+    std::vector<char> buf(32768);
+    while (true)
+    {
+        // With MSG_TRUNC the full length of a message that did not fit is
+        // returned, rather than the part that did.
+        ssize_t len = ::recv(fd.get(), buf.data(), buf.size(), MSG_TRUNC);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return std::unexpected(errno);
+        }
+        if (len == 0)
+        {
+            return std::unexpected(EPROTO);
+        }
+        if (static_cast<size_t>(len) > buf.size())
+        {
+            return std::unexpected(EMSGSIZE);
+        }
+
+        for (const auto* message =
+                 reinterpret_cast<const nlmsghdr*>(buf.data());
+             NLMSG_OK(message, len); message = NLMSG_NEXT(message, len))
+        {
+            if (message->nlmsg_seq != request.header.nlmsg_seq)
+            {
+                continue;
+            }
+            if (message->nlmsg_type == NLMSG_DONE)
+            {
+                return links;
+            }
+            if (message->nlmsg_type == NLMSG_ERROR)
+            {
+                const auto* err =
+                    static_cast<const nlmsgerr*>(NLMSG_DATA(message));
+                return std::unexpected(err->error ? -err->error : EPROTO);
+            }
+            if (auto link = parseLinkMessage(message))
+            {
+                links.push_back(std::move(*link));
+            }
+        }
+    }
+}
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,71 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <linux/netlink.h>
+
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/** One network interface, as reported by RTM_NEWLINK. */
+struct LinkStats
+{
+    int index;
+    std::string name;
+    // IFF_* flags, such as IFF_LOWER_UP when there is a carrier.
+    unsigned flags;
+    // IF_OPER_* state.
+    std::uint8_t operState;
+    std::uint64_t rxPackets;
+    std::uint64_t txPackets;
+};
+
+/** An interface, with how many packets it moved since it was last queried. */
+struct LinkStatus
+{
+    LinkStats stats;
+    std::uint64_t rxDelta;
+    std::uint64_t txDelta;
+};
+
+/**
+ * Parse one RTM_NEWLINK message.
+ *
+ * The counters come from IFLA_STATS64, or IFLA_STATS on kernels without it.
+ *
+ * @param[in] message - the message, with its header.
+ * @return the interface, or std::nullopt if the message is not a well formed
+ *         RTM_NEWLINK with a name.
+ */
+std::optional<LinkStats> parseLinkMessage(const nlmsghdr* message);
+
+/**
+ * Get every interface and its counters with a single RTM_GETLINK dump.
+ *
+ * @return the interfaces, in kernel order, or the errno of the failure;
+ *         EMSGSIZE if a dump message did not fit in the receive buffer.
+ */
+std::expected<std::vector<LinkStats>, int> dumpLinkStats();
+
+} // namespace ipmi
+} // namespace google
@@ -12,12 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "config.h"
+
 #include "handler_impl.hpp"
 #include "ipmi.hpp"
 
 #include <ipmid/api.h>
 
 #include <ipmid/api-types.hpp>
+#include <ipmid/api.hpp>
 #include <ipmid/handler.hpp>
 #include <ipmid/iana.hpp>
 #include <stdplus/print.hpp>
@@ -45,6 +48,10 @@ void setupGoogleOemSysCommands() __attribute__((constructor));
 void setupGoogleOemSysCommands()
 {
     static Handler handlerImpl;
+#if ENTITY_MANAGER_NAMES
+    // ipmid sets up its bus before loading providers.
+    handlerImpl.useEntityManagerNames(::getSdBus());
+#endif
 
     stdplus::print(
         stderr, "Registering OEM:[{:#08X}], Cmd:[{:#04X}] for Sys Commands\n",
@@ -0,0 +1,133 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mtd_partitions.hpp"
+
+#include "scoped_fd.hpp"
+
+#include <fcntl.h>
+#include <mtd/mtd-abi.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <stdplus/print.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+std::vector<std::tuple<unsigned int, std::string>> parseProcMtd(
+    std::string_view contents)
+{
+    std::vector<std::tuple<unsigned int, std::string>> devices;
+    while (!contents.empty())
+    {
+        auto line = contents.substr(0, contents.find('\n'));
+        contents.remove_prefix(std::min(contents.size(), line.size() + 1));
+
+        // The header line, "dev:    size   erasesize  name", is skipped too.
+        if (!line.starts_with("mtd"))
+        {
+            continue;
+        }
+        unsigned int index;
+        auto [ptr, ec] =
+            std::from_chars(line.data() + 3, line.data() + line.size(), index);
+        if (ec != std::errc() || ptr == line.data() + line.size() ||
+            *ptr != ':')
+        {
+            continue;
+        }
+
+        auto open = line.find('"');
+        auto close = line.rfind('"');
+        if (open == std::string_view::npos || close == open)
+        {
+            continue;
+        }
+        devices.emplace_back(index,
+                             std::string(line.substr(open + 1,
+                                                     close - open - 1)));
+    }
+    return devices;
+}
+
+std::expected<std::vector<MtdPartition>, int> readMtdPartitions()
+{
+    ScopedFd file(::open("/proc/mtd", O_RDONLY | O_CLOEXEC));
+    if (file.get() < 0)
+    {
+        return std::unexpected(errno);
+    }
+    // procfs reports no size, so read until the end.
+    std::string contents;
+    std::array<char, 4096> buf;
+    ssize_t len;
+    while ((len = ::read(file.get(), buf.data(), buf.size())) != 0)
+    {
+        if (len < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return std::unexpected(errno);
+        }
+        contents.append(buf.data(), len);
+    }
+
+    std::vector<MtdPartition> partitions;
+    for (auto& [index, name] : parseProcMtd(contents))
+    {
+        std::string path = std::format("/dev/mtd{}", index);
+        ScopedFd fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (fd.get() < 0)
+        {
+            stdplus::print(stderr, "Failed to open {}: {}\n", path,
+                           std::strerror(errno));
+            continue;
+        }
+
+        mtd_info_user info;
+        if (::ioctl(fd.get(), MEMGETINFO, &info) < 0)
+        {
+            stdplus::print(stderr, "MEMGETINFO failed on {}: {}\n", path,
+                           std::strerror(errno));
+            continue;
+        }
+
+        partitions.push_back(MtdPartition{index, std::move(name), info.size,
+                                          info.erasesize, info.flags});
+    }
+    return partitions;
+}
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,60 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/** One MTD device, as /dev/mtd<index>. */
+struct MtdPartition
+{
+    unsigned int index;
+    std::string name;
+    std::uint32_t size;
+    std::uint32_t eraseSize;
+    // MTD_* flags, such as MTD_WRITEABLE.
+    std::uint32_t flags;
+
+    bool operator==(const MtdPartition&) const = default;
+};
+
+/**
+ * Parse the contents of /proc/mtd.
+ *
+ * @param[in] contents - the file, as "mtd0: 04000000 00010000 \"bmc\"" lines.
+ * @return (index, name) of each device, in file order.
+ */
+std::vector<std::tuple<unsigned int, std::string>> parseProcMtd(
+    std::string_view contents);
+
+/**
+ * Get the geometry of every MTD device listed in /proc/mtd, with MEMGETINFO.
+ * A device that cannot be opened or queried is left out.
+ *
+ * @return the devices, in /proc/mtd order, or the errno of reading it.
+ */
+std::expected<std::vector<MtdPartition>, int> readMtdPartitions();
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,115 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <ipmid/api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * The reply to one page of a list: a Header, then as many records as fit in
+ * one IPMI reply.
+ *
+ * Header starts with a more byte, which full() sets. The command fills in
+ * its own next cursor. If Header has a recordCount, add() counts records in
+ * it.
+ */
+template <typename Header>
+class PagedReply
+{
+  public:
+    /** The most a reply can hold, as it also carries the subcommand byte. */
+    static constexpr size_t maxLength = MAX_IPMI_BUFFER - 1;
+    /** The longest record that fits in a page of its own. */
+    static constexpr size_t maxRecordLength = maxLength - sizeof(Header);
+
+    Header header = {};
+
+    PagedReply() : reply(sizeof(Header))
+    {
+        reply.reserve(maxLength);
+    }
+
+    /**
+     * Whether the page has no room left for a record of recordLength bytes.
+     * If so, the reply is marked as having more to come.
+     */
+    bool full(size_t recordLength)
+    {
+        if (reply.size() + recordLength <= maxLength)
+        {
+            return false;
+        }
+        header.more = 1;
+        return true;
+    }
+
+    /**
+     * Add one record, made of the given parts in order. A part is a packed
+     * struct or byte, a string, or a span of bytes.
+     */
+    template <typename... Parts>
+    void add(const Parts&... parts)
+    {
+        (append(parts), ...);
+        if constexpr (requires { header.recordCount; })
+        {
+            ++header.recordCount;
+        }
+    }
+
+    /** The header followed by the records. */
+    std::vector<std::uint8_t> bytes() &&
+    {
+        std::memcpy(reply.data(), &header, sizeof(header));
+        return std::move(reply);
+    }
+
+  private:
+    void append(std::string_view part)
+    {
+        reply.insert(reply.end(), part.begin(), part.end());
+    }
+
+    void append(std::span<const std::uint8_t> part)
+    {
+        reply.insert(reply.end(), part.begin(), part.end());
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void append(const T& part)
+    {
+        auto bytes = reinterpret_cast<const std::uint8_t*>(&part);
+        reply.insert(reply.end(), bytes, bytes + sizeof(part));
+    }
+
+    std::vector<std::uint8_t> reply;
+};
+
+} // namespace ipmi
+} // namespace google
@@ -19,11 +19,15 @@
 #include "commands.hpp"
 #include "errors.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
 
 #include <ipmid/api-types.hpp>
 #include <stdplus/print.hpp>
 
+#include <cstdint>
+#include <cstring>
 #include <span>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -71,5 +75,53 @@ Resp pcieBifurcation(std::span<const uint8_t> data, HandlerInterface* handler)
     return ::ipmi::responseSuccess(SysOEMCommands::SysPCIeSlotBifurcation,
                                    reply);
 }
+
+Resp pcieBifurcationList(std::span<const uint8_t> data,
+                         HandlerInterface* handler)
+{
+    struct PcieBifurcationListRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n",
+                       static_cast<uint32_t>(data.size()));
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+
+    using Page = PagedReply<struct PcieBifurcationListReply>;
+    Page page;
+    for (const auto& [index, bifurcation] : handler->pcieBifurcations())
+    {
+        if (index < request.pcieIndex)
+        {
+            continue;
+        }
+
+        size_t recordLength =
+            sizeof(index) + sizeof(struct PcieBifurcationReply) +
+            bifurcation.size();
+        if (recordLength > Page::maxRecordLength)
+        {
+            // Can never fit in a page; SysPCIeSlotBifurcation may still read
+            // it.
+            stdplus::print(stderr, "Skipping pcie slot {}, too many lanes\n",
+                           index);
+            continue;
+        }
+        if (page.full(recordLength))
+        {
+            page.header.nextIndex = index;
+            break;
+        }
+
+        page.add(index, static_cast<std::uint8_t>(bifurcation.size()),
+                 bifurcation);
+    }
+
+    return ::ipmi::responseSuccess(SysOEMCommands::SysPCIeSlotBifurcationList,
+                                   std::move(page).bytes());
+}
 } // namespace ipmi
 } // namespace google
@@ -30,5 +30,23 @@ struct PcieBifurcationReply
 
 Resp pcieBifurcation(std::span<const uint8_t> data, HandlerInterface* handler);
 
+struct PcieBifurcationListRequest
+{
+    uint8_t pcieIndex;
+} __attribute__((packed));
+
+struct PcieBifurcationListReply
+{
+    uint8_t more;
+    uint8_t nextIndex;
+    uint8_t recordCount;
+} __attribute__((packed));
+
+// Handle the bulk PCIe bifurcation command.
+// Sys can read the bifurcation of as many slots as fit in a reply, starting at
+// a slot index.
+Resp pcieBifurcationList(std::span<const uint8_t> data,
+                         HandlerInterface* handler);
+
 } // namespace ipmi
 } // namespace google
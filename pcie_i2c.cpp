@@ -16,15 +16,20 @@
 
 #include "commands.hpp"
 #include "handler.hpp"
+#include "paged_reply.hpp"
 
 #include <ipmid/api-types.hpp>
 #include <stdplus/print.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <span>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace google
@@ -36,54 +41,86 @@ namespace ipmi
 #define MAX_IPMI_BUFFER 64
 #endif
 
+namespace
+{
+
+// The snapshot a lookup reads: the current one, rescanned if the slots may
+// have changed, or the one the host counted.
+std::shared_ptr<const PcieSlotSnapshot> lookupSnapshot(
+    HandlerInterface* handler, std::uint8_t generation)
+{
+    if (generation == 0)
+    {
+        return handler->buildI2cPcieMapping();
+    }
+    return handler->getI2cPcieMapping(generation);
+}
+
+} // namespace
+
 struct PcieSlotI2cBusMappingRequest
 {
     uint8_t entry;
+    // Optional; older hosts send only the entry and get the current snapshot.
+    uint8_t generation;
 } __attribute__((packed));
 
-Resp pcieSlotCount(std::span<const uint8_t>, HandlerInterface* handler)
+Resp pcieSlotCount(std::span<const uint8_t> data, HandlerInterface* handler)
 {
-    // If there are already entries in the vector, clear them.
-    handler->buildI2cPcieMapping();
+    struct PcieSlotCountRequest request = {};
+    if (!data.empty())
+    {
+        std::memcpy(&request, data.data(), sizeof(request));
+    }
+
+    // Rescan if the slots may have changed since the last count.
+    auto snapshot = handler->buildI2cPcieMapping();
 
-    // Fill the pcie slot count as the number of entries in the vector.
-    std::uint8_t value = handler->getI2cPcieMappingSize();
+    // Fill the pcie slot count as the number of entries in the snapshot, and
+    // its generation for the mapping requests to echo if the host asked.
+    struct PcieSlotCountReply reply;
+    reply.value = snapshot->slots.size();
+    reply.generation = snapshot->generation;
 
-    return ::ipmi::responseSuccess(SysOEMCommands::SysPcieSlotCount,
-                                   std::vector<std::uint8_t>{value});
+    std::vector<std::uint8_t> bytes{reply.value};
+    if (request.flags & pcieSlotCountWithGeneration)
+    {
+        bytes.push_back(reply.generation);
+    }
+    return ::ipmi::responseSuccess(SysOEMCommands::SysPcieSlotCount, bytes);
 }
 
 Resp pcieSlotI2cBusMapping(std::span<const uint8_t> data,
                            HandlerInterface* handler)
 {
-    struct PcieSlotI2cBusMappingRequest request;
+    struct PcieSlotI2cBusMappingRequest request = {};
 
-    if (data.size() < sizeof(request))
+    if (data.size() < sizeof(request.entry))
     {
         stdplus::print(stderr, "Invalid command length: {}\n", data.size());
         return ::ipmi::responseReqDataLenInvalid();
     }
 
-    // If there are no entries in the vector return error.
-    size_t mapSize = handler->getI2cPcieMappingSize();
-    if (mapSize == 0)
+    std::memcpy(&request, data.data(), std::min(data.size(), sizeof(request)));
+
+    // If the snapshot was never built, has been dropped or is empty, the
+    // host has to count again.
+    auto snapshot = handler->getI2cPcieMapping(request.generation);
+    if (!snapshot || snapshot->slots.empty())
     {
         return ::ipmi::responseInvalidReservationId();
     }
 
-    std::memcpy(&request, data.data(), sizeof(request));
-
     // The valid entries range from 0 to N - 1, N being the total number of
-    // entries in the vector.
-    if (request.entry >= mapSize)
+    // entries in the snapshot.
+    if (request.entry >= snapshot->slots.size())
     {
         return ::ipmi::responseParmOutOfRange();
     }
 
-    // Get the i2c bus number and the pcie slot name from the vector.
-    auto i2cEntry = handler->getI2cEntry(request.entry);
-    uint32_t i2c_bus_number = std::get<0>(i2cEntry);
-    std::string pcie_slot_name = std::get<1>(i2cEntry);
+    // Get the i2c bus number and the pcie slot name from the snapshot.
+    const auto& [i2c_bus_number, pcie_slot_name] =
+        snapshot->slots[request.entry];
 
     int length = sizeof(struct PcieSlotI2cBusMappingReply) +
                  pcie_slot_name.length();
@@ -108,5 +145,160 @@ Resp pcieSlotI2cBusMapping(std::span<const uint8_t> data,
     return ::ipmi::responseSuccess(SysOEMCommands::SysPcieSlotI2cBusMapping,
                                    reply);
 }
+
+Resp pcieSlotI2cBusMappingList(std::span<const uint8_t> data,
+                               HandlerInterface* handler)
+{
+    struct PcieSlotI2cBusMappingListRequest request = {};
+
+    if (data.size() < sizeof(request.entry))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), std::min(data.size(), sizeof(request)));
+
+    // A first page without a generation takes the place of SysPcieSlotCount.
+    // Later pages name the generation they started on, so they keep reading
+    // the same snapshot even if it has been replaced since.
+    std::shared_ptr<const PcieSlotSnapshot> snapshot;
+    if (request.entry == 0 && request.generation == 0)
+    {
+        snapshot = handler->buildI2cPcieMapping();
+    }
+    else
+    {
+        snapshot = handler->getI2cPcieMapping(request.generation);
+        if (!snapshot)
+        {
+            return ::ipmi::responseInvalidReservationId();
+        }
+    }
+
+    const auto& slots = snapshot->slots;
+    if (request.entry > 0 && request.entry >= slots.size())
+    {
+        return ::ipmi::responseParmOutOfRange();
+    }
+
+    using Page = PagedReply<struct PcieSlotI2cBusMappingListReply>;
+    Page page;
+    page.header.generation = snapshot->generation;
+
+    for (size_t entry = request.entry; entry < slots.size(); ++entry)
+    {
+        const auto& [i2c_bus_number, pcie_slot_name] = slots[entry];
+        size_t recordLength =
+            sizeof(struct PcieSlotI2cBusMappingReply) + pcie_slot_name.size();
+        if (recordLength > Page::maxRecordLength)
+        {
+            // Can never fit in a reply; the entry is still counted so the
+            // single entry command keeps the same numbering.
+            stdplus::print(stderr, "Skipping pcie slot {}, name too long\n",
+                           entry);
+            continue;
+        }
+        if (page.full(recordLength))
+        {
+            page.header.nextEntry = entry;
+            break;
+        }
+
+        page.add(static_cast<std::uint8_t>(i2c_bus_number),
+                 static_cast<std::uint8_t>(pcie_slot_name.size()),
+                 pcie_slot_name);
+    }
+
+    return ::ipmi::responseSuccess(
+        SysOEMCommands::SysPcieSlotI2cBusMappingList, std::move(page).bytes());
+}
+
+Resp pcieSlotByName(std::span<const uint8_t> data, HandlerInterface* handler)
+{
+    struct PcieSlotByNameRequest request;
+
+    if (data.size() < sizeof(request))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), sizeof(request));
+    if (data.size() < sizeof(request) + request.pcie_slot_name_len)
+    {
+        stdplus::print(stderr, "Invalid string length: {}\n",
+                       request.pcie_slot_name_len);
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+    std::string_view name(
+        reinterpret_cast<const char*>(data.data() + sizeof(request)),
+        request.pcie_slot_name_len);
+
+    auto snapshot = lookupSnapshot(handler, request.generation);
+    if (!snapshot)
+    {
+        return ::ipmi::responseInvalidReservationId();
+    }
+
+    auto entry = snapshot->findName(name);
+    if (!entry)
+    {
+        return ::ipmi::responseInvalidFieldRequest();
+    }
+
+    struct PcieSlotByNameReply reply;
+    reply.generation = snapshot->generation;
+    reply.entry = *entry;
+    reply.i2c_bus_number = std::get<0>(snapshot->slots[*entry]);
+
+    return ::ipmi::responseSuccess(
+        SysOEMCommands::SysPcieSlotByName,
+        std::vector<std::uint8_t>{reply.generation, reply.entry,
+                                  reply.i2c_bus_number});
+}
+
+Resp pcieSlotByBus(std::span<const uint8_t> data, HandlerInterface* handler)
+{
+    struct PcieSlotByBusRequest request = {};
+
+    if (data.size() < sizeof(request.i2c_bus_number))
+    {
+        stdplus::print(stderr, "Invalid command length: {}\n", data.size());
+        return ::ipmi::responseReqDataLenInvalid();
+    }
+
+    std::memcpy(&request, data.data(), std::min(data.size(), sizeof(request)));
+
+    auto snapshot = lookupSnapshot(handler, request.generation);
+    if (!snapshot)
+    {
+        return ::ipmi::responseInvalidReservationId();
+    }
+
+    auto entry = snapshot->findBus(request.i2c_bus_number);
+    if (!entry)
+    {
+        return ::ipmi::responseInvalidFieldRequest();
+    }
+
+    const auto& name = std::get<1>(snapshot->slots[*entry]);
+    // The reply also carries the subcommand byte.
+    if (1 + sizeof(struct PcieSlotByBusReply) + name.size() > MAX_IPMI_BUFFER)
+    {
+        stdplus::print(stderr, "Response would overflow response buffer\n");
+        return ::ipmi::responseInvalidCommand();
+    }
+
+    std::vector<std::uint8_t> reply;
+    reply.reserve(sizeof(struct PcieSlotByBusReply) + name.size());
+    reply.emplace_back(snapshot->generation);
+    reply.emplace_back(*entry);
+    reply.emplace_back(name.size());
+    reply.insert(reply.end(), name.begin(), name.end());
+
+    return ::ipmi::responseSuccess(SysOEMCommands::SysPcieSlotByBus, reply);
+}
+
 } // namespace ipmi
 } // namespace google
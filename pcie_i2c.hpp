@@ -27,9 +27,20 @@ namespace google
 namespace ipmi
 {
 
+struct PcieSlotCountRequest
+{
+    // Optional; older hosts send no flags and get only the count.
+    uint8_t flags;
+} __attribute__((packed));
+
+// Ask for the generation to follow the count.
+constexpr uint8_t pcieSlotCountWithGeneration = 1 << 0;
+
 struct PcieSlotCountReply
 {
     uint8_t value;
+    // Only if the request asked for it.
+    uint8_t generation;
 } __attribute__((packed));
 
 struct PcieSlotI2cBusMappingReply
@@ -47,5 +58,58 @@ Resp pcieSlotCount(std::span<const uint8_t> data, HandlerInterface* handler);
 Resp pcieSlotI2cBusMapping(std::span<const uint8_t> data,
                            HandlerInterface* handler);
 
+struct PcieSlotI2cBusMappingListRequest
+{
+    uint8_t entry;
+    // Optional; 0 or absent on the first page.
+    uint8_t generation;
+} __attribute__((packed));
+
+struct PcieSlotI2cBusMappingListReply
+{
+    uint8_t more;
+    uint8_t nextEntry;
+    uint8_t recordCount;
+    uint8_t generation;
+} __attribute__((packed));
+
+// Handle the bulk pcie slot to i2c bus mapping command.
+// Sys can read as many mappings as fit in a reply, starting at an entry.
+Resp pcieSlotI2cBusMappingList(std::span<const uint8_t> data,
+                               HandlerInterface* handler);
+
+struct PcieSlotByNameRequest
+{
+    uint8_t generation;
+    uint8_t pcie_slot_name_len;
+} __attribute__((packed));
+
+struct PcieSlotByNameReply
+{
+    uint8_t generation;
+    uint8_t entry;
+    uint8_t i2c_bus_number;
+} __attribute__((packed));
+
+struct PcieSlotByBusRequest
+{
+    uint8_t i2c_bus_number;
+    // Optional; 0 or absent for the current snapshot.
+    uint8_t generation;
+} __attribute__((packed));
+
+struct PcieSlotByBusReply
+{
+    uint8_t generation;
+    uint8_t entry;
+    uint8_t pcie_slot_name_len;
+} __attribute__((packed));
+
+// Handle the pcie slot name to i2c bus lookup command.
+Resp pcieSlotByName(std::span<const uint8_t> data, HandlerInterface* handler);
+
+// Handle the i2c bus to pcie slot name lookup command.
+Resp pcieSlotByBus(std::span<const uint8_t> data, HandlerInterface* handler);
+
 } // namespace ipmi
 } // namespace google
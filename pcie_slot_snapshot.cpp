@@ -0,0 +1,65 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pcie_slot_snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+PcieSlotSnapshot::PcieSlotSnapshot(std::uint8_t generation,
+                                   std::vector<Slot> slots) :
+    generation(generation), slots(std::move(slots))
+{
+    byName.reserve(this->slots.size());
+    byBus.reserve(this->slots.size());
+    for (std::size_t i = 0; i < this->slots.size(); ++i)
+    {
+        const auto& [bus, name] = this->slots[i];
+        byName.try_emplace(name, i);
+        byBus.try_emplace(bus, i);
+    }
+}
+
+std::optional<std::size_t> PcieSlotSnapshot::findName(
+    std::string_view name) const
+{
+    auto it = byName.find(name);
+    if (it == byName.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::optional<std::size_t> PcieSlotSnapshot::findBus(std::uint32_t bus) const
+{
+    auto it = byBus.find(bus);
+    if (it == byBus.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,80 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * One build of the i2c bus to PCIe slot name mapping. A snapshot is never
+ * changed once published, so a host can page through it while a newer one is
+ * built.
+ *
+ * Slots can also be looked up by name or by bus through hash indexes built
+ * with the snapshot. If a name or bus appears more than once, the first entry
+ * wins.
+ */
+struct PcieSlotSnapshot
+{
+    using Slot = std::tuple<std::uint32_t, std::string>;
+
+    PcieSlotSnapshot(std::uint8_t generation, std::vector<Slot> slots);
+
+    /**
+     * Return the entry number of the slot with a name.
+     *
+     * @param[in] name - the PCIe slot name.
+     * @return the index into slots, or std::nullopt if there is none.
+     */
+    std::optional<std::size_t> findName(std::string_view name) const;
+
+    /**
+     * Return the entry number of the slot on an i2c bus.
+     *
+     * @param[in] bus - the i2c bus number.
+     * @return the index into slots, or std::nullopt if there is none.
+     */
+    std::optional<std::size_t> findBus(std::uint32_t bus) const;
+
+    // Never 0, which requests use to ask for the current snapshot.
+    std::uint8_t generation;
+    std::vector<Slot> slots;
+
+  private:
+    // Lets byName be searched with a std::string_view.
+    struct NameHash : std::hash<std::string_view>
+    {
+        using is_transparent = void;
+    };
+
+    std::unordered_map<std::string, std::size_t, NameHash, std::equal_to<>>
+        byName;
+    std::unordered_map<std::uint32_t, std::size_t> byBus;
+};
+
+} // namespace ipmi
+} // namespace google
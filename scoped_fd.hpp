@@ -0,0 +1,75 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <unistd.h>
+
+#include <utility>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * Owns a file descriptor, or -1, and closes it when destroyed.
+ *
+ * Unlike stdplus::ManagedFd, taking a descriptor makes no fcntl() calls and
+ * cannot throw.
+ */
+class ScopedFd
+{
+  public:
+    ScopedFd() = default;
+    explicit ScopedFd(int fd) : fd(fd) {}
+    ~ScopedFd()
+    {
+        reset();
+    }
+
+    ScopedFd(ScopedFd&& other) noexcept : fd(std::exchange(other.fd, -1)) {}
+    ScopedFd& operator=(ScopedFd&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset(std::exchange(other.fd, -1));
+        }
+        return *this;
+    }
+
+    ScopedFd(const ScopedFd&) = delete;
+    ScopedFd& operator=(const ScopedFd&) = delete;
+
+    int get() const
+    {
+        return fd;
+    }
+
+    /** Close the descriptor held, if any, and hold fd instead. */
+    void reset(int newFd = -1)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        fd = newFd;
+    }
+
+  private:
+    int fd = -1;
+};
+
+} // namespace ipmi
+} // namespace google
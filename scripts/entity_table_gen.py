@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+# Copyright 2026 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Compile an entity association map into a constexpr EntityNameIndex table.
+
+The output header defines, in the given namespace:
+    entityEntries - std::array of EntityNameIndex::Entry, sorted by key
+    entityNames   - std::string_view over every name, back to back
+
+Records are selected exactly as EntityNameIndex(const nlohmann::json&) does,
+which the entity_table unit test checks against a fixture.
+"""
+
+import argparse
+import json
+import sys
+
+# Must match entityTypes in entity_index.hpp.
+ENTITY_TYPES = {
+    0x03: "cpu",
+    0x04: "storage_device",
+    0x06: "system_management_module",
+    0x07: "system_board",
+    0x08: "memory_module",
+    0x0B: "add_in_card",
+    0x0E: "power_system_board",
+    0x10: "system_internal_expansion_board",
+    0x11: "other_system_board",
+    0x17: "system_chassis",
+    0x1D: "fan",
+    0x1E: "cooling_unit",
+    0x20: "memory_device",
+}
+
+MAX_NAME_LENGTH = 0xFFFF
+
+
+def is_integer(value):
+    return isinstance(value, int) and not isinstance(value, bool)
+
+
+def build(config):
+    """Return [(key, name bytes)] sorted by key, first record per key."""
+    if not isinstance(config, dict):
+        return []
+
+    records = []
+    for entity_id, entity_type in sorted(ENTITY_TYPES.items()):
+        readings = config.get(entity_type)
+        if not isinstance(readings, list):
+            continue
+
+        for reading in readings:
+            if not isinstance(reading, dict):
+                continue
+
+            instance = reading.get("instance", 0)
+            if not is_integer(instance):
+                continue
+
+            name = reading.get("name")
+            if isinstance(name, str):
+                name = name.encode()
+                if not name or len(name) > MAX_NAME_LENGTH:
+                    name = None
+            else:
+                name = None
+
+            records.append((entity_id << 8 | (instance & 0xFF), name))
+
+    # Stable, so the first record for a key stays in front and hides the rest
+    # even when it has no name.
+    records.sort(key=lambda record: record[0])
+    table = []
+    last = None
+    for key, name in records:
+        if key != last and name is not None:
+            table.append((key, name))
+        last = key
+    return table
+
+
+def c_string(data):
+    out = []
+    for byte in data:
+        char = chr(byte)
+        if char in '"\\':
+            out.append("\\" + char)
+        elif 0x20 <= byte < 0x7F and char != "?":
+            out.append(char)
+        else:
+            out.append("\\%03o" % byte)
+    return '"' + "".join(out) + '"'
+
+
+def render(table, namespace):
+    lines = [
+        "// Generated by entity_table_gen.py; do not edit.",
+        "",
+        "#pragma once",
+        "",
+        '#include "entity_index.hpp"',
+        "",
+        "#include <array>",
+        "#include <string_view>",
+        "",
+        f"namespace {namespace}",
+        "{",
+        "",
+        "inline constexpr std::array<::google::ipmi::EntityNameIndex::Entry, "
+        f"{len(table)}>",
+        "    entityEntries{{",
+    ]
+
+    offset = 0
+    names = b""
+    for key, name in table:
+        lines.append(f"        {{{key:#06x}, {len(name)}, {offset}}},")
+        offset += len(name)
+        names += name
+    lines += [
+        "    }};",
+        "",
+        "inline constexpr char entityNameData[] =",
+    ]
+
+    chunk = 48
+    parts = [names[i : i + chunk] for i in range(0, len(names), chunk)]
+    for part in parts or [b""]:
+        lines.append("    " + c_string(part))
+    lines[-1] += ";"
+
+    lines += [
+        "",
+        "inline constexpr std::string_view entityNames(entityNameData,",
+        "                                              "
+        "sizeof(entityNameData) - 1);",
+        "",
+        f"}} // namespace {namespace}",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="entity association map JSON")
+    parser.add_argument("output", help="header to write")
+    parser.add_argument(
+        "--namespace",
+        default="google::ipmi::generated",
+        help="namespace for the generated table",
+    )
+    args = parser.parse_args()
+
+    try:
+        with open(args.input, encoding="utf-8") as f:
+            config = json.load(f)
+    except (OSError, ValueError) as e:
+        sys.exit(f"{args.input}: {e}")
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(render(build(config), args.namespace))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,231 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bifurcation.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace fs = std::filesystem;
+
+class BifurcationDynamicTest : public ::testing::Test
+{
+  protected:
+    BifurcationDynamicTest()
+    {
+        char tmpl[] = "/tmp/bifurcation_dynamicXXXXXX";
+        root = ::mkdtemp(tmpl);
+        sysfs = root + "/sys";
+        deviceTree = root + "/firmware/devicetree/base";
+        staticFile = root + "/bifurcation.json";
+        fs::create_directories(sysfs + "/bus/pci/devices");
+        fs::create_directories(deviceTree);
+    }
+
+    ~BifurcationDynamicTest() override
+    {
+        fs::remove_all(root);
+    }
+
+    static void write(const std::string& path, const std::string& data)
+    {
+        fs::create_directories(fs::path(path).parent_path());
+        std::ofstream(path, std::ios::binary) << data;
+    }
+
+    void addSlot(int bus, const std::string& node)
+    {
+        write(std::format("{}/bus/i2c/devices/i2c-{}/of_node/pcie-slot", sysfs,
+                          bus),
+              node + '\0');
+        fs::create_directories(deviceTree + node);
+    }
+
+    void setLanes(const std::string& node, uint8_t lanes)
+    {
+        // A single big-endian cell.
+        write(deviceTree + node + "/num-lanes",
+              std::string{0, 0, 0, static_cast<char>(lanes)});
+    }
+
+    void addPciDevice(const std::string& name, const std::string& node,
+                      const std::string& width)
+    {
+        auto dev = std::format("{}/bus/pci/devices/{}", sysfs, name);
+        write(dev + "/max_link_width", width);
+        fs::create_directory_symlink(deviceTree + node, dev + "/of_node");
+    }
+
+    BifurcationDynamic make(
+        std::chrono::milliseconds retryDelay = std::chrono::seconds(1))
+    {
+        return BifurcationDynamic(sysfs, deviceTree, staticFile, retryDelay);
+    }
+
+    std::string root;
+    std::string sysfs;
+    std::string deviceTree;
+    std::string staticFile;
+};
+
+TEST_F(BifurcationDynamicTest, PortsInUnitAddressOrder)
+{
+    addSlot(3, "/ahb/pcie-slot@3");
+    setLanes("/ahb/pcie-slot@3/port@10", 4);
+    setLanes("/ahb/pcie-slot@3/port@2", 8);
+    setLanes("/ahb/pcie-slot@3/port@0", 4);
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{4, 8, 4}), bifurcation.getBifurcation(0));
+}
+
+TEST_F(BifurcationDynamicTest, SlotWithoutPorts)
+{
+    addSlot(5, "/ahb/pcie-slot@5");
+    setLanes("/ahb/pcie-slot@5", 16);
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{16}), bifurcation.getBifurcation(0));
+}
+
+TEST_F(BifurcationDynamicTest, WidthFromPciDevice)
+{
+    addSlot(7, "/ahb/pcie-slot@7");
+    fs::create_directories(deviceTree + "/ahb/pcie-slot@7/port@0");
+    setLanes("/ahb/pcie-slot@7/port@1", 4);
+    addPciDevice("0000:01:00.0", "/ahb/pcie-slot@7/port@0", "8\n");
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{8, 4}), bifurcation.getBifurcation(0));
+}
+
+TEST_F(BifurcationDynamicTest, SlotsIndexedInBusOrder)
+{
+    addSlot(12, "/ahb/pcie-slot@c");
+    setLanes("/ahb/pcie-slot@c", 4);
+    addSlot(3, "/ahb/pcie-slot@3");
+    setLanes("/ahb/pcie-slot@3", 16);
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{16}), bifurcation.getBifurcation(0));
+    EXPECT_EQ((std::vector<uint8_t>{4}), bifurcation.getBifurcation(1));
+    EXPECT_EQ(std::nullopt, bifurcation.getBifurcation(3));
+    EXPECT_EQ(std::nullopt, bifurcation.getBifurcation(12));
+}
+
+TEST_F(BifurcationDynamicTest, StaticConfigWithoutDerivedSlots)
+{
+    write(staticFile, R"({"9": [ 1, 2 ], "12": [ 16 ]})");
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{1, 2}), bifurcation.getBifurcation(9));
+    EXPECT_EQ((std::vector<uint8_t>{16}), bifurcation.getBifurcation(12));
+    EXPECT_EQ(std::nullopt, bifurcation.getBifurcation(11));
+    std::vector<std::tuple<uint8_t, std::vector<uint8_t>>> expected = {
+        {9, {1, 2}}, {12, {16}}};
+    EXPECT_EQ(expected, bifurcation.getBifurcations());
+}
+
+TEST_F(BifurcationDynamicTest, StaticConfigMergedPerSlot)
+{
+    // Slot 0 is on bus 5 and derived, so it overrides the static entry. Slot
+    // 1, on bus 9, has no width and keeps its static entry, as do the slots
+    // on no bus.
+    addSlot(5, "/ahb/pcie-slot@5");
+    setLanes("/ahb/pcie-slot@5", 16);
+    addSlot(9, "/ahb/pcie-slot@9");
+    fs::create_directories(deviceTree + "/ahb/pcie-slot@9/port@0");
+    write(staticFile,
+          R"({"0": [ 1 ], "1": [ 2, 2 ], "5": [ 8 ], "12": [ 4, 4 ]})");
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{16}), bifurcation.getBifurcation(0));
+    EXPECT_EQ((std::vector<uint8_t>{2, 2}), bifurcation.getBifurcation(1));
+    EXPECT_EQ((std::vector<uint8_t>{8}), bifurcation.getBifurcation(5));
+    EXPECT_EQ((std::vector<uint8_t>{4, 4}), bifurcation.getBifurcation(12));
+    std::vector<std::tuple<uint8_t, std::vector<uint8_t>>> expected = {
+        {0, {16}}, {1, {2, 2}}, {5, {8}}, {12, {4, 4}}};
+    EXPECT_EQ(expected, bifurcation.getBifurcations());
+}
+
+TEST_F(BifurcationDynamicTest, UnresolvedScannedAgainWhenInvalidated)
+{
+    addSlot(7, "/ahb/pcie-slot@7");
+    setLanes("/ahb/pcie-slot@7/port@1", 4);
+    addSlot(9, "/ahb/pcie-slot@9");
+    fs::create_directories(deviceTree + "/ahb/pcie-slot@9/port@0");
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{4}), bifurcation.getBifurcation(0));
+    EXPECT_EQ(std::nullopt, bifurcation.getBifurcation(1));
+
+    // The PCI device shows up later; the partial table is kept until the
+    // topology is reported changed.
+    addPciDevice("0000:01:00.0", "/ahb/pcie-slot@9/port@0", "8\n");
+    EXPECT_EQ(std::nullopt, bifurcation.getBifurcation(1));
+    bifurcation.invalidate();
+    EXPECT_EQ((std::vector<uint8_t>{8}), bifurcation.getBifurcation(1));
+}
+
+TEST_F(BifurcationDynamicTest, UnresolvedScannedAgainAfterDelay)
+{
+    addSlot(9, "/ahb/pcie-slot@9");
+    fs::create_directories(deviceTree + "/ahb/pcie-slot@9/port@0");
+
+    auto bifurcation = make(std::chrono::milliseconds(20));
+    EXPECT_EQ(std::nullopt, bifurcation.getBifurcation(0));
+
+    // Scanned again by a call once the delay is up; give it a few seconds.
+    addPciDevice("0000:01:00.0", "/ahb/pcie-slot@9/port@0", "8\n");
+    auto lanes = bifurcation.getBifurcation(0);
+    for (int i = 0; i < 500 && !lanes; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        lanes = bifurcation.getBifurcation(0);
+    }
+    EXPECT_EQ((std::vector<uint8_t>{8}), lanes);
+}
+
+TEST_F(BifurcationDynamicTest, KeptUntilInvalidated)
+{
+    addSlot(5, "/ahb/pcie-slot@5");
+    setLanes("/ahb/pcie-slot@5", 16);
+
+    auto bifurcation = make();
+    EXPECT_EQ((std::vector<uint8_t>{16}), bifurcation.getBifurcation(0));
+
+    setLanes("/ahb/pcie-slot@5", 8);
+    EXPECT_EQ((std::vector<uint8_t>{16}), bifurcation.getBifurcation(0));
+    bifurcation.invalidate();
+    EXPECT_EQ((std::vector<uint8_t>{8}), bifurcation.getBifurcation(0));
+}
+
+} // namespace ipmi
+} // namespace google
@@ -18,6 +18,7 @@
 #include "helper.hpp"
 
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -72,5 +73,64 @@ TEST(GetBMInstancePropertyTest, ValidRequest)
                 StrEq(expectedOutput));
 }
 
+TEST(GetBMInstancePropertiesTest, InvalidRequestSize)
+{
+    std::vector<uint8_t> request = {0};
+
+    HandlerMock hMock;
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              getBMInstanceProperties(request, &hMock));
+}
+
+TEST(GetBMInstancePropertiesTest, SingleReply)
+{
+    std::vector<uint8_t> request = {0, 0};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getBMInstanceProperties(true))
+        .WillOnce(Return(std::vector<std::tuple<uint8_t, std::string>>{
+            {0, "tag"}, {6, "id"}}));
+
+    auto result = ValidateReply(getBMInstanceProperties(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysGetBMInstanceProperties, result.first);
+    EXPECT_EQ((std::vector<uint8_t>{0, 0, 0, 0, 3, 't', 'a', 'g', 6, 2, 'i',
+                                    'd'}),
+              result.second);
+}
+
+TEST(GetBMInstancePropertiesTest, Fragmented)
+{
+    // 2 + 30 and 2 + 40 bytes of fields; 60 fit after the header.
+    std::vector<std::tuple<uint8_t, std::string>> properties = {
+        {1, std::string(30, 'a')}, {5, std::string(40, 'b')}};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getBMInstanceProperties(true))
+        .WillOnce(Return(properties));
+    EXPECT_CALL(hMock, getBMInstanceProperties(false))
+        .WillRepeatedly(Return(properties));
+
+    std::vector<uint8_t> request = {0, 0};
+    auto result = ValidateReply(getBMInstanceProperties(request, &hMock));
+    auto& data = result.second;
+    ASSERT_EQ(sizeof(BMInstancePropertiesReply) + 60, data.size());
+    EXPECT_EQ(1, data[0]);
+    EXPECT_EQ(60, data[1]);
+    EXPECT_EQ(0, data[2]);
+    EXPECT_EQ(1, data[3]);
+    EXPECT_EQ(30, data[4]);
+    EXPECT_EQ(5, data[35]);
+    EXPECT_EQ(40, data[36]);
+
+    request = {60, 0};
+    result = ValidateReply(getBMInstanceProperties(request, &hMock));
+    EXPECT_EQ(sizeof(BMInstancePropertiesReply) + 14, result.second.size());
+    EXPECT_EQ(0, result.second[0]);
+
+    request = {74, 0};
+    EXPECT_EQ(::ipmi::responseParmOutOfRange(),
+              getBMInstanceProperties(request, &hMock));
+}
+
 } // namespace ipmi
 } // namespace google
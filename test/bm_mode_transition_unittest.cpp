@@ -19,11 +19,15 @@
 #include "handler.hpp"
 #include "handler_impl.hpp"
 
+#include <stdplus/gtest/tmp.hpp>
+
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -115,5 +119,42 @@ TEST(BmcModeTransitionTest, NonBmMode)
     EXPECT_EQ(h.getBmcMode(), static_cast<uint8_t>(BmcMode::NON_BM_MODE));
 }
 
+class TmpFlagsHandler : public MockFsHandler
+{
+  public:
+    TmpFlagsHandler(std::unique_ptr<FileSystemMock> mock,
+                    const std::string& dir) :
+        MockFsHandler(std::move(mock)), dir(dir)
+    {}
+
+  protected:
+    // Watch files in dir rather than the real flag files.
+    std::vector<std::string> getBmcModeFlagPaths() const override
+    {
+        return {dir + "/ack", dir + "/done", dir + "/signal"};
+    }
+
+  private:
+    std::string dir;
+};
+
+class BmcModeCacheTest : public stdplus::gtest::TestWithTmp
+{};
+
+TEST_F(BmcModeCacheTest, ModeIsCached)
+{
+    // The flag files are only checked again once one of them changes.
+    auto fsMockPtr = std::make_unique<FileSystemMock>();
+    EXPECT_CALL(*fsMockPtr, exists(fs::path(bmDriveCleaningDoneAckFlagPath), _))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*fsMockPtr, exists(fs::path(bmDriveCleaningDoneFlagPath), _))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*fsMockPtr, exists(fs::path(BM_SIGNAL_PATH), _))
+        .WillOnce(Return(false));
+    TmpFlagsHandler h(move(fsMockPtr), CaseTmpDir());
+    EXPECT_EQ(h.getBmcMode(), static_cast<uint8_t>(BmcMode::NON_BM_MODE));
+    EXPECT_EQ(h.getBmcMode(), static_cast<uint8_t>(BmcMode::NON_BM_MODE));
+}
+
 } // namespace ipmi
 } // namespace google
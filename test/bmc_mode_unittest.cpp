@@ -17,10 +17,13 @@
 #include "handler_mock.hpp"
 #include "helper.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+using ::testing::_;
 using ::testing::Return;
 
 namespace google
@@ -69,5 +72,41 @@ TEST(BmcModeCommandTest, ValidRequest)
     EXPECT_EQ(2, data[0]);
 }
 
+TEST(WaitBmcModeChangeCommandTest, InvalidRequest)
+{
+    std::vector<std::uint8_t> request = {2};
+
+    HandlerMock hMock;
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              waitBmcModeChange(nullptr, request, &hMock));
+}
+
+TEST(WaitBmcModeChangeCommandTest, ValidRequest)
+{
+    // Waiting up to 3 seconds to leave BM cleaning mode.
+    std::vector<std::uint8_t> request = {2, 3};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, waitBmcModeChange(_, 2, std::chrono::milliseconds(3000)))
+        .WillOnce(Return(1));
+
+    auto result = ValidateReply(waitBmcModeChange(nullptr, request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysWaitBmcModeChange, result.first);
+    EXPECT_EQ(std::vector<std::uint8_t>{1}, result.second);
+}
+
+TEST(WaitBmcModeChangeCommandTest, TimeoutIsCapped)
+{
+    std::vector<std::uint8_t> request = {2, 255};
+
+    HandlerMock hMock;
+    auto capped = std::chrono::milliseconds(maxBmcModeWait);
+    EXPECT_CALL(hMock, waitBmcModeChange(_, 2, capped)).WillOnce(Return(2));
+
+    auto result = ValidateReply(waitBmcModeChange(nullptr, request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysWaitBmcModeChange, result.first);
+    EXPECT_EQ(std::vector<std::uint8_t>{2}, result.second);
+}
+
 } // namespace ipmi
 } // namespace google
@@ -17,8 +17,11 @@
 #include "handler_mock.hpp"
 #include "helper.hpp"
 
+#include <linux/if.h>
+
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -79,5 +82,75 @@ TEST(CableCommandTest, ValidRequestValidReturn)
     EXPECT_EQ(expectedReply.value, data[0]);
 }
 
+LinkStatus makeStatus(const std::string& name, unsigned flags,
+                      std::uint8_t operState, std::uint64_t rxDelta,
+                      std::uint64_t txDelta)
+{
+    return LinkStatus{LinkStats{1, name, flags, operState, 0, 0}, rxDelta,
+                      txDelta};
+}
+
+TEST(CableCheckAllCommandTest, RequestTooSmall)
+{
+    std::vector<std::uint8_t> request = {};
+    HandlerMock hMock;
+
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              cableCheckAll(request, &hMock));
+}
+
+TEST(CableCheckAllCommandTest, FirstPageRefreshes)
+{
+    std::vector<std::uint8_t> request = {0};
+    HandlerMock hMock;
+
+    EXPECT_CALL(hMock, getLinkStatuses(true))
+        .WillOnce(Return(std::vector<LinkStatus>{
+            makeStatus("eth0", IFF_LOWER_UP, IF_OPER_UP, 5,
+                       0x1'0000'0000),
+            makeStatus("eth1", IFF_UP, IF_OPER_DOWN, 0, 2)}));
+
+    auto result = ValidateReply(cableCheckAll(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysCableCheckAll, result.first);
+    EXPECT_EQ((std::vector<std::uint8_t>{
+                  0, 0, 2,
+                  // eth0: up, carrier and received packets.
+                  0x07, 5, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 4, 'e', 't', 'h',
+                  '0',
+                  // eth1: down.
+                  0x00, 0, 0, 0, 0, 2, 0, 0, 0, 4, 'e', 't', 'h', '1'}),
+              result.second);
+}
+
+TEST(CableCheckAllCommandTest, Paged)
+{
+    std::vector<LinkStatus> statuses;
+    for (int i = 0; i < 5; ++i)
+    {
+        statuses.push_back(makeStatus("eth" + std::to_string(i), IFF_UP,
+                                      IF_OPER_UP, 0, 0));
+    }
+    HandlerMock hMock;
+
+    // 3 header bytes and 14 bytes per interface fill a page at 4.
+    std::vector<std::uint8_t> request = {0};
+    EXPECT_CALL(hMock, getLinkStatuses(true)).WillOnce(Return(statuses));
+    auto first = ValidateReply(cableCheckAll(request, &hMock)).second;
+    EXPECT_EQ(1, first[0]);
+    EXPECT_EQ(4, first[1]);
+    EXPECT_EQ(4, first[2]);
+
+    request = {first[1]};
+    EXPECT_CALL(hMock, getLinkStatuses(false)).WillOnce(Return(statuses));
+    auto second = ValidateReply(cableCheckAll(request, &hMock)).second;
+    EXPECT_EQ(0, second[0]);
+    EXPECT_EQ(1, second[2]);
+    EXPECT_EQ('4', second.back());
+
+    request = {5};
+    EXPECT_CALL(hMock, getLinkStatuses(false)).WillOnce(Return(statuses));
+    EXPECT_EQ(::ipmi::responseParmOutOfRange(), cableCheckAll(request, &hMock));
+}
+
 } // namespace ipmi
 } // namespace google
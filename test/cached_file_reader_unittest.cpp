@@ -0,0 +1,171 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cached_file_reader.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace fs = std::filesystem;
+
+class CachedFileReaderTest : public ::testing::Test
+{
+  protected:
+    CachedFileReaderTest()
+    {
+        char tmpl[] = "/tmp/cached_file_readerXXXXXX";
+        dir = ::mkdtemp(tmpl);
+    }
+
+    ~CachedFileReaderTest() override
+    {
+        fs::remove_all(dir);
+    }
+
+    static void write(const std::string& path, const std::string& data)
+    {
+        std::ofstream(path, std::ios::binary) << data;
+    }
+
+    static std::string read(const CachedFileReader& reader,
+                            const std::string& path)
+    {
+        std::array<char, 64> buf;
+        auto len = reader.read(path, buf);
+        EXPECT_TRUE(len.has_value());
+        return std::string(buf.data(), len.value_or(0));
+    }
+
+    std::string read(const std::string& path)
+    {
+        return read(reader, path);
+    }
+
+    // Replace the file at path by renaming a new one over it.
+    static void replace(const std::string& path, const std::string& data)
+    {
+        write(path + ".tmp", data);
+        fs::rename(path + ".tmp", path);
+    }
+
+    std::string dir;
+    // Checks the path on every read.
+    CachedFileReader reader{2, std::chrono::milliseconds(0)};
+};
+
+TEST_F(CachedFileReaderTest, RereadsInPlaceWrites)
+{
+    auto path = dir + "/rx_packets";
+    write(path, "42\n");
+    EXPECT_EQ("42\n", read(path));
+
+    write(path, "43\n");
+    EXPECT_EQ("43\n", read(path));
+}
+
+TEST_F(CachedFileReaderTest, FollowsReplacement)
+{
+    auto path = dir + "/cpld0.version";
+    write(path, "1.2.3.4");
+    EXPECT_EQ("1.2.3.4", read(path));
+
+    replace(path, "5.6.7.8");
+    EXPECT_EQ("5.6.7.8", read(path));
+
+    fs::remove(path);
+    std::array<char, 8> buf;
+    EXPECT_EQ(std::unexpected(ENOENT), reader.read(path, buf));
+}
+
+TEST_F(CachedFileReaderTest, EvictsPastLimit)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        auto path = dir + "/" + std::to_string(i);
+        write(path, std::to_string(i));
+        EXPECT_EQ(std::to_string(i), read(path));
+    }
+    EXPECT_EQ("0", read(dir + "/0"));
+}
+
+TEST_F(CachedFileReaderTest, EmptyReadChecksPath)
+{
+    // Between rechecks the open file is read, until it comes back empty.
+    CachedFileReader slow(2, std::chrono::hours(1));
+    auto path = dir + "/cpld0.version";
+    write(path, "1.2.3.4");
+    EXPECT_EQ("1.2.3.4", read(slow, path));
+
+    write(path, "");
+    replace(path, "5.6.7.8");
+    EXPECT_EQ("5.6.7.8", read(slow, path));
+}
+
+TEST_F(CachedFileReaderTest, EvictsLeastRecentlyRead)
+{
+    // Between rechecks an open file is read even once replaced, so a file
+    // that was closed is told apart by reading its replacement.
+    CachedFileReader slow(2, std::chrono::hours(1));
+    for (int i = 0; i < 3; ++i)
+    {
+        write(dir + "/" + std::to_string(i), std::to_string(i));
+    }
+    EXPECT_EQ("0", read(slow, dir + "/0"));
+    EXPECT_EQ("1", read(slow, dir + "/1"));
+    EXPECT_EQ("0", read(slow, dir + "/0"));
+
+    replace(dir + "/0", "new 0");
+    replace(dir + "/1", "new 1");
+    EXPECT_EQ("2", read(slow, dir + "/2"));
+    EXPECT_EQ("0", read(slow, dir + "/0"));
+    EXPECT_EQ("new 1", read(slow, dir + "/1"));
+}
+
+TEST_F(CachedFileReaderTest, ReadAll)
+{
+    auto path = dir + "/cpu_config.json";
+    std::string contents(10000, 'x');
+    write(path, contents);
+    EXPECT_EQ(contents, reader.readAll(path));
+    EXPECT_EQ(std::unexpected(ENOENT), reader.readAll(dir + "/missing"));
+}
+
+TEST(CachedFileReaderParseTest, Tokens)
+{
+    EXPECT_EQ("1.2.3", firstToken("  1.2.3 \n"));
+    EXPECT_EQ("", firstToken(" \n"));
+    EXPECT_EQ("serial 1", firstLine("serial 1\nrest"));
+    EXPECT_EQ(std::optional<std::int64_t>(1234),
+              parseInteger<std::int64_t>("1234\n"));
+    EXPECT_EQ(std::nullopt, parseInteger<std::int64_t>("12x\n"));
+    EXPECT_EQ(std::nullopt, parseInteger<std::uint8_t>("256"));
+}
+
+} // namespace ipmi
+} // namespace google
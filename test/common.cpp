@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <user_channel/channel_layer.hpp>
+
 #include <cstdint>
 #include <string>
 
@@ -21,4 +23,36 @@ std::uint8_t getChannelByName(const std::string& chName)
 {
     return chName.size() + 10;
 }
+
+// Channels 1, 2 and 10 are LAN channels, 3 is not valid and 8 is IPMB.
+bool isValidChannel(const std::uint8_t chNum)
+{
+    return chNum == 1 || chNum == 2 || chNum == 8 || chNum == 10;
+}
+
+Cc getChannelInfo(const std::uint8_t chNum, ChannelInfo& chInfo)
+{
+    chInfo = {};
+    chInfo.mediumType = static_cast<std::uint8_t>(
+        chNum == 8 ? EChannelMediumType::ipmb : EChannelMediumType::lan8032);
+    return ccSuccess;
+}
+
+std::string getChannelName(const std::uint8_t chNum)
+{
+    switch (chNum)
+    {
+        case 1:
+            return "eth0";
+        case 2:
+            return "eth1";
+        case 3:
+            return "eth2";
+        case 8:
+            return "ipmb0";
+        case 10:
+            return "usb0";
+    }
+    return "";
+}
 } // namespace ipmi
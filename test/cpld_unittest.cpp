@@ -18,6 +18,8 @@
 #include "helper.hpp"
 
 #include <cstdint>
+#include <expected>
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -30,6 +32,27 @@ namespace google
 namespace ipmi
 {
 
+TEST(CpldParseVersionTest, AllFields)
+{
+    EXPECT_EQ(std::make_tuple(1, 2, 3, 4), parseVersion("1.2.3.4"));
+}
+
+TEST(CpldParseVersionTest, MissingFieldsAreZero)
+{
+    EXPECT_EQ(std::make_tuple(1, 2, 0, 0), parseVersion("1.2"));
+}
+
+TEST(CpldParseVersionTest, FieldAboveAByteIsTruncated)
+{
+    EXPECT_EQ(std::make_tuple(1, 2, 44, 4), parseVersion("1.2.300.4"));
+    EXPECT_EQ(std::make_tuple(0, 0, 0, 0), parseVersion("256"));
+}
+
+TEST(CpldParseVersionTest, NotANumberIsInvalid)
+{
+    EXPECT_EQ(std::nullopt, parseVersion("abc"));
+}
+
 TEST(CpldCommandTest, RequestTooSmall)
 {
     std::vector<std::uint8_t> request = {};
@@ -67,5 +90,74 @@ TEST(CpldCommandTest, ValidRequestReturnsHappy)
     EXPECT_EQ(expectedSbPtr, data[3]);
 }
 
+TEST(CpldCommandTest, HandlerErrorIsReturned)
+{
+    std::vector<std::uint8_t> request = {0x04};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getCpldVersion(0x04))
+        .WillOnce(Return(std::unexpected(::ipmi::ccInvalidFieldRequest)));
+
+    EXPECT_EQ(::ipmi::response(::ipmi::ccInvalidFieldRequest),
+              cpldVersion(request, &hMock));
+}
+
+TEST(CpldVersionsCommandTest, RequestTooSmall)
+{
+    std::vector<std::uint8_t> request = {};
+    HandlerMock hMock;
+
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              cpldVersions(request, &hMock));
+}
+
+TEST(CpldVersionsCommandTest, Paged)
+{
+    // Twelve records fit after the header.
+    std::vector<std::tuple<std::uint8_t, VersionTuple>> versions;
+    for (std::uint8_t id = 1; id <= 14; ++id)
+    {
+        versions.emplace_back(id, std::make_tuple(id, 2, 3, 4));
+    }
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getCpldVersions()).WillRepeatedly(Return(versions));
+
+    std::vector<std::uint8_t> request = {0};
+    auto result = ValidateReply(cpldVersions(request, &hMock));
+    auto& data = result.second;
+
+    EXPECT_EQ(SysOEMCommands::SysCpldVersions, result.first);
+    ASSERT_EQ(sizeof(CpldVersionsReply) + 12 * sizeof(CpldVersionsRecord),
+              data.size());
+    EXPECT_EQ(1, data[0]);
+    EXPECT_EQ(13, data[1]);
+    EXPECT_EQ(12, data[2]);
+    EXPECT_EQ((std::vector<std::uint8_t>{1, 1, 2, 3, 4, 2, 2, 2, 3, 4}),
+              std::vector<std::uint8_t>(data.begin() + 3, data.begin() + 13));
+
+    request = {13};
+    result = ValidateReply(cpldVersions(request, &hMock));
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 2, 13, 13, 2, 3, 4, 14, 14, 2,
+                                         3, 4}),
+              result.second);
+}
+
+TEST(CpldVersionsCommandTest, RecordsFromId)
+{
+    std::vector<std::tuple<std::uint8_t, VersionTuple>> versions = {
+        {1, {1, 2, 3, 4}}, {4, {4, 2, 3, 4}}, {7, {7, 0, 0, 1}}};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getCpldVersions()).WillOnce(Return(versions));
+
+    std::vector<std::uint8_t> request = {2};
+    auto result = ValidateReply(cpldVersions(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysCpldVersions, result.first);
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 2, 4, 4, 2, 3, 4, 7, 7, 0, 0,
+                                         1}),
+              result.second);
+}
+
 } // namespace ipmi
 } // namespace google
@@ -0,0 +1,122 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "entity_index.hpp"
+#include "handler_impl.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+TEST(EntityIndexTest, EntityTypeNames)
+{
+    EXPECT_EQ("cpu", entityTypeName(0x03));
+    EXPECT_EQ("memory_device", entityTypeName(0x20));
+    EXPECT_EQ(std::nullopt, entityTypeName(0x00));
+    EXPECT_EQ(std::nullopt, entityTypeName(0x05));
+    EXPECT_EQ(std::nullopt, entityTypeName(0xff));
+}
+
+TEST(EntityIndexTest, EmptyAndMalformedConfigs)
+{
+    EXPECT_TRUE(EntityNameIndex().empty());
+    EXPECT_TRUE(EntityNameIndex(nlohmann::json::array()).empty());
+    EXPECT_TRUE(EntityNameIndex(R"({"cpu": {"instance": 1}})"_json).empty());
+
+    auto j = R"(
+      {
+        "cpu": [
+          "CPU0",
+          {"instance": "2", "name": "CPU1"},
+          {"instance": 3, "name": 7},
+          {"instance": 4, "name": "CPU3"}
+        ],
+        "not_an_entity": [{"instance": 1, "name": "X"}]
+      }
+    )"_json;
+    EntityNameIndex index(j);
+    EXPECT_EQ(1u, index.size());
+    EXPECT_EQ("CPU3", index.find(0x03, 4));
+}
+
+TEST(EntityIndexTest, LookupsAcrossTypes)
+{
+    auto j = R"(
+      {
+        "fan": [
+          {"instance": 2, "name": "fan1"},
+          {"instance": 1, "name": "fan0"}
+        ],
+        "cpu": [
+          {"instance": 1, "name": "CPU0"},
+          {"name": "CPU_DEFAULT"}
+        ]
+      }
+    )"_json;
+    EntityNameIndex index(j);
+
+    EXPECT_EQ(4u, index.size());
+    EXPECT_EQ("CPU0", index.find(0x03, 1));
+    EXPECT_EQ("CPU_DEFAULT", index.find(0x03, 0));
+    EXPECT_EQ("fan0", index.find(0x1D, 1));
+    EXPECT_EQ("fan1", index.find(0x1D, 2));
+    EXPECT_EQ(std::nullopt, index.find(0x1D, 3));
+    EXPECT_EQ(std::nullopt, index.find(0x04, 1));
+}
+
+TEST(EntityIndexTest, MatchesReadNameFromConfig)
+{
+    // Duplicate instances resolve to the first record, even when it has no
+    // name, and out of range instances truncate the same way.
+    auto j = R"(
+      {
+        "cpu": [
+          {"instance": 1, "name": "first"},
+          {"instance": 1, "name": "second"},
+          {"instance": 2},
+          {"instance": 2, "name": "hidden"},
+          {"instance": 3, "name": ""},
+          {"instance": 260, "name": "wrapped"}
+        ]
+      }
+    )"_json;
+    EntityNameIndex index(j);
+
+    for (unsigned instance = 0; instance < 256; ++instance)
+    {
+        std::string expected = readNameFromConfig("cpu", instance, j);
+        auto actual = index.find(0x03, instance);
+        if (expected.empty())
+        {
+            EXPECT_EQ(std::nullopt, actual) << instance;
+        }
+        else
+        {
+            EXPECT_EQ(expected, actual) << instance;
+        }
+    }
+}
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,132 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "entity_manager_names.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+using PropertyMap = EntityManagerNames::PropertyMap;
+
+constexpr char boardPath[] = "/xyz/openbmc_project/inventory/system/board/Dev";
+constexpr char cpuPath[] = "/xyz/openbmc_project/inventory/system/cpu/CPU_0";
+constexpr char boardIntf[] = "xyz.openbmc_project.Inventory.Item.Board";
+constexpr char cpuIntf[] = "xyz.openbmc_project.Configuration.Cpu";
+
+TEST(EntityManagerNamesTest, NoIndexBeforeSnapshot)
+{
+    EntityManagerNames names;
+    EXPECT_EQ(nullptr, names.index());
+}
+
+TEST(EntityManagerNamesTest, SnapshotIsIndexed)
+{
+    EntityManagerNames names;
+    names.replace({
+        {sdbusplus::message::object_path(boardPath),
+         {{boardIntf,
+           PropertyMap{{"EntityId", std::uint64_t{0x07}},
+                       {"EntityInstance", std::uint64_t{1}},
+                       {"Name", std::string("Mainboard")}}},
+          {"xyz.openbmc_project.Inventory.Decorator.Asset",
+           PropertyMap{{"SerialNumber", std::string("1234")}}}}},
+        {sdbusplus::message::object_path(cpuPath),
+         {{cpuIntf, PropertyMap{{"EntityId", double{3}},
+                                {"EntityInstance", std::int64_t{0}}}}}},
+    });
+
+    auto index = names.index();
+    ASSERT_NE(nullptr, index);
+    EXPECT_EQ(2u, index->size());
+    EXPECT_EQ("Mainboard", index->find(0x07, 1));
+    // Without a Name the object path names the entity.
+    EXPECT_EQ("CPU_0", index->find(0x03, 0));
+}
+
+TEST(EntityManagerNamesTest, MalformedPropertiesAreSkipped)
+{
+    EntityManagerNames names;
+    names.replace({
+        {sdbusplus::message::object_path(cpuPath),
+         {{"a", PropertyMap{{"EntityId", std::uint64_t{3}}}},
+          {"b", PropertyMap{{"EntityId", std::uint64_t{3}},
+                            {"EntityInstance", std::uint64_t{256}}}},
+          {"c", PropertyMap{{"EntityId", std::int64_t{-1}},
+                            {"EntityInstance", std::uint64_t{1}}}},
+          {"d", PropertyMap{{"EntityId", double{3.5}},
+                            {"EntityInstance", std::uint64_t{1}}}},
+          {"e", PropertyMap{{"EntityId", std::string("3")},
+                            {"EntityInstance", std::uint64_t{1}}}}}},
+    });
+
+    auto index = names.index();
+    ASSERT_NE(nullptr, index);
+    EXPECT_TRUE(index->empty());
+}
+
+TEST(EntityManagerNamesTest, SignalsUpdateTheIndex)
+{
+    EntityManagerNames names;
+    names.replace({});
+    ASSERT_NE(nullptr, names.index());
+    EXPECT_TRUE(names.index()->empty());
+
+    names.interfacesAdded(
+        cpuPath, {{cpuIntf, PropertyMap{{"EntityId", std::uint64_t{3}},
+                                        {"EntityInstance", std::uint64_t{1}},
+                                        {"Name", std::string("CPU0")}}}});
+    names.interfacesAdded(
+        boardPath, {{boardIntf, PropertyMap{{"EntityId", std::uint64_t{7}},
+                                            {"EntityInstance",
+                                             std::uint64_t{1}}}}});
+    auto before = names.index();
+    EXPECT_EQ("CPU0", before->find(0x03, 1));
+    EXPECT_EQ("Dev", before->find(0x07, 1));
+
+    names.interfacesRemoved(cpuPath, {cpuIntf});
+    EXPECT_EQ(std::nullopt, names.index()->find(0x03, 1));
+    EXPECT_EQ("Dev", names.index()->find(0x07, 1));
+    // Earlier indexes stay valid for readers still holding them.
+    EXPECT_EQ("CPU0", before->find(0x03, 1));
+
+    names.clear();
+    EXPECT_TRUE(names.index()->empty());
+}
+
+TEST(EntityManagerNamesTest, DuplicateEntitiesResolveByPath)
+{
+    EntityManagerNames names;
+    names.interfacesAdded(
+        cpuPath, {{cpuIntf, PropertyMap{{"EntityId", std::uint64_t{3}},
+                                        {"EntityInstance", std::uint64_t{1}},
+                                        {"Name", std::string("second")}}}});
+    names.interfacesAdded(
+        boardPath,
+        {{boardIntf, PropertyMap{{"EntityId", std::uint64_t{3}},
+                                 {"EntityInstance", std::uint64_t{1}},
+                                 {"Name", std::string("first")}}}});
+
+    EXPECT_EQ("first", names.index()->find(0x03, 1));
+}
+
+} // namespace ipmi
+} // namespace google
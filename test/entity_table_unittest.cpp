@@ -0,0 +1,67 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "entity_index.hpp"
+#include "test_entity_table.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+// The generator duplicates the record selection rules of EntityNameIndex;
+// build the same fixture both ways so the two cannot drift apart.
+TEST(EntityTableTest, GeneratedTableMatchesRuntimeIndex)
+{
+    std::ifstream ifs(ENTITY_MAP_FIXTURE);
+    ASSERT_TRUE(ifs.is_open());
+    EntityNameIndex runtime(nlohmann::json::parse(ifs));
+    EntityNameIndex generated(test_table::entityEntries,
+                              test_table::entityNames);
+
+    ASSERT_FALSE(runtime.empty());
+    EXPECT_EQ(runtime.size(), generated.size());
+    for (unsigned id = 0; id < 256; ++id)
+    {
+        for (unsigned instance = 0; instance < 256; ++instance)
+        {
+            EXPECT_EQ(runtime.find(id, instance),
+                      generated.find(id, instance))
+                << id << ":" << instance;
+        }
+    }
+}
+
+TEST(EntityTableTest, GeneratedTableIsSorted)
+{
+    const auto& entries = test_table::entityEntries;
+    for (std::size_t i = 1; i < entries.size(); ++i)
+    {
+        EXPECT_LT(entries[i - 1].key, entries[i].key);
+    }
+    for (const auto& entry : entries)
+    {
+        EXPECT_LE(entry.nameOffset + entry.nameLength,
+                  test_table::entityNames.size());
+    }
+}
+
+} // namespace ipmi
+} // namespace google
@@ -13,13 +13,19 @@
 // limitations under the License.
 
 #include "commands.hpp"
+#include "entity_index.hpp"
 #include "entity_name.hpp"
 #include "handler_mock.hpp"
 #include "helper.hpp"
 
+#include <nlohmann/json.hpp>
+
 #include <cstdint>
 #include <cstring>
+#include <expected>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -66,5 +72,122 @@ TEST(EntityNameCommandTest, ValidRequest)
                           data.end()));
 }
 
+std::shared_ptr<const EntityNameIndex> makeIndex(int cpus)
+{
+    nlohmann::json j;
+    for (int i = 0; i < cpus; ++i)
+    {
+        j["cpu"].push_back(
+            {{"instance", i}, {"name", "CPU" + std::to_string(i)}});
+    }
+    j["fan"] = R"([{"instance": 1, "name": "fan0"}])"_json;
+    return std::make_shared<const EntityNameIndex>(j);
+}
+
+// Walk the records of a SysEntityNameList reply, returning the records and
+// the header.
+std::pair<GetEntityNameListReply,
+          std::vector<std::tuple<std::uint8_t, std::uint8_t, std::string>>>
+    parseList(const std::vector<std::uint8_t>& data)
+{
+    GetEntityNameListReply header;
+    EXPECT_LE(sizeof(header), data.size());
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    std::vector<std::tuple<std::uint8_t, std::uint8_t, std::string>> records;
+    size_t pos = sizeof(header);
+    while (pos + sizeof(EntityNameRecord) <= data.size())
+    {
+        std::uint8_t len = data[pos + 2];
+        records.emplace_back(
+            data[pos], data[pos + 1],
+            std::string(data.begin() + pos + 3, data.begin() + pos + 3 + len));
+        pos += sizeof(EntityNameRecord) + len;
+    }
+    EXPECT_EQ(data.size(), pos);
+    EXPECT_EQ(header.recordCount, records.size());
+    return {header, records};
+}
+
+TEST(EntityNameListCommandTest, InvalidCommandLength)
+{
+    std::vector<std::uint8_t> request = {0x01};
+    HandlerMock hMock;
+
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              getEntityNameList(request, &hMock));
+}
+
+TEST(EntityNameListCommandTest, IndexUnavailable)
+{
+    std::vector<std::uint8_t> request = {0x00, 0x00};
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getEntityNameIndex())
+        .WillOnce(Return(std::unexpected(::ipmi::ccUnspecifiedError)));
+
+    EXPECT_EQ(::ipmi::response(::ipmi::ccUnspecifiedError),
+              getEntityNameList(request, &hMock));
+}
+
+TEST(EntityNameListCommandTest, SinglePage)
+{
+    std::vector<std::uint8_t> request = {0x00, 0x00};
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getEntityNameIndex()).WillOnce(Return(makeIndex(2)));
+
+    auto result = ValidateReply(getEntityNameList(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysEntityNameList, result.first);
+
+    auto [header, records] = parseList(result.second);
+    EXPECT_EQ(0, header.more);
+    ASSERT_EQ(3u, records.size());
+    EXPECT_EQ(std::make_tuple(0x03, 0, "CPU0"), records[0]);
+    EXPECT_EQ(std::make_tuple(0x03, 1, "CPU1"), records[1]);
+    EXPECT_EQ(std::make_tuple(0x1D, 1, "fan0"), records[2]);
+}
+
+TEST(EntityNameListCommandTest, PagesCoverEveryRecordOnce)
+{
+    auto index = makeIndex(40);
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getEntityNameIndex()).WillRepeatedly(Return(index));
+
+    std::vector<std::uint8_t> request = {0x00, 0x00};
+    std::vector<std::tuple<std::uint8_t, std::uint8_t, std::string>> all;
+    for (int pages = 0; pages < 100; ++pages)
+    {
+        auto result = ValidateReply(getEntityNameList(request, &hMock));
+        EXPECT_GE(static_cast<size_t>(MAX_IPMI_BUFFER),
+                  result.second.size() + 1);
+
+        auto [header, records] = parseList(result.second);
+        ASSERT_FALSE(records.empty());
+        all.insert(all.end(), records.begin(), records.end());
+        if (!header.more)
+        {
+            break;
+        }
+        request = {header.nextEntityId, header.nextEntityInstance};
+    }
+
+    ASSERT_EQ(index->size(), all.size());
+    for (const auto& [id, instance, name] : all)
+    {
+        EXPECT_EQ(index->find(id, instance), name);
+    }
+}
+
+TEST(EntityNameListCommandTest, CursorPastTheEnd)
+{
+    std::vector<std::uint8_t> request = {0xff, 0xff};
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getEntityNameIndex()).WillOnce(Return(makeIndex(2)));
+
+    auto result = ValidateReply(getEntityNameList(request, &hMock));
+    auto [header, records] = parseList(result.second);
+    EXPECT_EQ(0, header.more);
+    EXPECT_TRUE(records.empty());
+}
+
 } // namespace ipmi
 } // namespace google
@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -81,5 +82,80 @@ TEST(EthCommandTest, ValidPopulatedReturnsSuccess)
               std::string(data.begin() + sizeof(struct EthDeviceReply),
                           data.end()));
 }
+
+TEST(EthDevicesCommandTest, RequestTooSmall)
+{
+    std::vector<std::uint8_t> request = {};
+
+    HandlerMock hMock;
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              getEthDevices(request, &hMock));
+}
+
+TEST(EthDevicesCommandTest, EntryOutOfRange)
+{
+    std::vector<std::uint8_t> request = {1};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getEthDevices())
+        .WillOnce(Return(std::vector<std::tuple<std::uint8_t, std::string>>{
+            {1, "eth0"}}));
+
+    EXPECT_EQ(::ipmi::responseParmOutOfRange(), getEthDevices(request, &hMock));
+}
+
+TEST(EthDevicesCommandTest, Records)
+{
+    std::vector<std::uint8_t> request = {0};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getEthDevices())
+        .WillOnce(Return(std::vector<std::tuple<std::uint8_t, std::string>>{
+            {1, "eth0"}, {2, "usb0"}}));
+
+    auto result = ValidateReply(getEthDevices(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysGetEthDevices, result.first);
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 2, 1, 4, 'e', 't', 'h', '0', 2,
+                                         4, 'u', 's', 'b', '0'}),
+              result.second);
+}
+
+TEST(EthDevicesCommandTest, Paged)
+{
+    // Three 22 byte records do not fit after the header.
+    std::vector<std::tuple<std::uint8_t, std::string>> devices = {
+        {1, std::string(20, 'a')},
+        {2, std::string(20, 'b')},
+        {3, std::string(20, 'c')},
+    };
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getEthDevices()).WillRepeatedly(Return(devices));
+
+    std::vector<std::uint8_t> request = {0};
+    auto result = ValidateReply(getEthDevices(request, &hMock));
+    auto& data = result.second;
+
+    EXPECT_EQ(SysOEMCommands::SysGetEthDevices, result.first);
+    ASSERT_EQ(sizeof(EthDevicesReply) + 2 * (sizeof(EthDeviceReply) + 20),
+              data.size());
+    EXPECT_EQ(1, data[0]);
+    EXPECT_EQ(2, data[1]);
+    EXPECT_EQ(2, data[2]);
+    EXPECT_EQ(1, data[3]);
+    EXPECT_EQ(20, data[4]);
+    EXPECT_EQ(std::string(20, 'a'),
+              std::string(data.begin() + 5, data.begin() + 25));
+    EXPECT_EQ(2, data[25]);
+
+    request = {2};
+    result = ValidateReply(getEthDevices(request, &hMock));
+    EXPECT_EQ(sizeof(EthDevicesReply) + sizeof(EthDeviceReply) + 20,
+              result.second.size());
+    EXPECT_EQ(0, result.second[0]);
+    EXPECT_EQ(1, result.second[2]);
+    EXPECT_EQ(3, result.second[3]);
+}
+
 } // namespace ipmi
 } // namespace google
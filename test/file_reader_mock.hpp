@@ -0,0 +1,42 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "cached_file_reader.hpp"
+
+#include <expected>
+#include <span>
+#include <string>
+
+#include <gmock/gmock.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+class FileReaderMock : public FileReaderInterface
+{
+  public:
+    ~FileReaderMock() = default;
+
+    MOCK_METHOD((std::expected<size_t, int>), read,
+                (const std::string&, std::span<char>), (const, override));
+    MOCK_METHOD((std::expected<std::string, int>), readAll,
+                (const std::string&), (const, override));
+};
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,136 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "flash_digest.hpp"
+
+#include <stdplus/gtest/tmp.hpp>
+
+#include <cerrno>
+#include <chrono>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+class FlashDigestTest : public stdplus::gtest::TestWithTmp
+{
+  public:
+    void writeDevice(unsigned int index, const std::string& data)
+    {
+        std::ofstream ofs(std::format("{}/mtd{}", CaseTmpDir(), index),
+                          std::ios::trunc);
+        ofs << data;
+    }
+
+    // Hashing happens on the digest thread; give it a few seconds.
+    std::expected<std::optional<Sha256>, int> waitFor(
+        FlashDigest& digest, const MtdPartition& partition,
+        bool rescan = false)
+    {
+        auto result = digest.get(partition, rescan);
+        for (int i = 0; i < 500 && result && !*result; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            result = digest.get(partition, rescan);
+        }
+        return result;
+    }
+
+    static std::string hex(const Sha256& digest)
+    {
+        std::string out;
+        for (auto byte : digest)
+        {
+            out += std::format("{:02x}", byte);
+        }
+        return out;
+    }
+
+    MtdPartition partition{0, "bmc", 3, 2, 0};
+};
+
+TEST_F(FlashDigestTest, HashesInTheBackground)
+{
+    writeDevice(0, "abc");
+    FlashDigest digest(CaseTmpDir());
+
+    EXPECT_EQ(std::nullopt, digest.get(partition));
+    auto result = waitFor(digest, partition);
+    ASSERT_TRUE(result && *result);
+    EXPECT_EQ(
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+        hex(**result));
+}
+
+TEST_F(FlashDigestTest, KeptUntilInvalidated)
+{
+    writeDevice(0, "abc");
+    FlashDigest digest(CaseTmpDir());
+    ASSERT_TRUE(waitFor(digest, partition).value());
+
+    writeDevice(0, "");
+    auto result = digest.get(partition);
+    ASSERT_TRUE(result && *result);
+    EXPECT_EQ(
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+        hex(**result));
+
+    digest.invalidate();
+    EXPECT_EQ(std::nullopt, digest.get(partition));
+    result = waitFor(digest, partition);
+    ASSERT_TRUE(result && *result);
+    EXPECT_EQ(
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+        hex(**result));
+}
+
+TEST_F(FlashDigestTest, PollingWithRescanEndsWithDigest)
+{
+    writeDevice(0, "abc");
+    FlashDigest digest(CaseTmpDir());
+    auto result = waitFor(digest, partition, true);
+    ASSERT_TRUE(result && *result);
+    EXPECT_EQ(
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+        hex(**result));
+
+    // Once returned, the next rescan hashes the device again.
+    writeDevice(0, "");
+    EXPECT_EQ(std::nullopt, digest.get(partition, true));
+    result = waitFor(digest, partition, true);
+    ASSERT_TRUE(result && *result);
+    EXPECT_EQ(
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+        hex(**result));
+}
+
+TEST_F(FlashDigestTest, MissingDeviceFailsOnce)
+{
+    FlashDigest digest(CaseTmpDir());
+
+    EXPECT_EQ(std::unexpected(ENOENT), waitFor(digest, partition));
+    EXPECT_EQ(std::nullopt, digest.get(partition));
+}
+
+} // namespace ipmi
+} // namespace google
@@ -17,8 +17,11 @@
 #include "handler_mock.hpp"
 #include "helper.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <expected>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -51,5 +54,135 @@ TEST(FlashSizeCommandTest, ValidRequest)
     EXPECT_EQ(0xE8, data[0]);
 }
 
+TEST(MtdPartitionsCommandTest, RequestTooSmall)
+{
+    std::vector<std::uint8_t> request = {};
+
+    HandlerMock hMock;
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              mtdPartitions(request, &hMock));
+}
+
+TEST(MtdPartitionsCommandTest, HandlerErrorIsReturned)
+{
+    std::vector<std::uint8_t> request = {0};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getMtdPartitions())
+        .WillOnce(Return(std::unexpected(::ipmi::ccUnspecifiedError)));
+
+    EXPECT_EQ(::ipmi::response(::ipmi::ccUnspecifiedError),
+              mtdPartitions(request, &hMock));
+}
+
+TEST(MtdPartitionsCommandTest, Records)
+{
+    std::vector<MtdPartition> partitions = {
+        {0, "bmc", 0x4000000, 0x10000, 0xc00},
+        {1, "u-boot", 0x60000, 0x10000, 0x400},
+    };
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getMtdPartitions()).WillOnce(Return(partitions));
+
+    std::vector<std::uint8_t> request = {1};
+    auto result = ValidateReply(mtdPartitions(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysMtdPartitions, result.first);
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 1, 1, 0, 0, 6, 0, 0, 0, 1, 0,
+                                         0, 0x04, 0, 0, 6, 'u', '-', 'b', 'o',
+                                         'o', 't'}),
+              result.second);
+}
+
+TEST(MtdPartitionsCommandTest, Paged)
+{
+    // Two 14 byte records with 16 byte names fill a page.
+    std::vector<MtdPartition> partitions = {
+        {0, "bmc", 0x4000000, 0x10000, 0xc00},
+        {1, std::string(16, 'a'), 0x60000, 0x10000, 0xc00},
+        {2, std::string(16, 'b'), 0x20000, 0x10000, 0x400},
+    };
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getMtdPartitions()).WillRepeatedly(Return(partitions));
+
+    std::vector<std::uint8_t> request = {0};
+    auto result = ValidateReply(mtdPartitions(request, &hMock));
+    auto& data = result.second;
+
+    EXPECT_EQ(SysOEMCommands::SysMtdPartitions, result.first);
+    ASSERT_EQ(sizeof(MtdPartitionsReply) + 2 * sizeof(MtdPartitionsRecord) +
+                  3 + 16,
+              data.size());
+    EXPECT_EQ((std::vector<std::uint8_t>{1, 2, 2, 0, 0, 0, 0, 4, 0, 0, 1, 0,
+                                         0, 0x0c, 0, 0, 3, 'b', 'm', 'c'}),
+              std::vector<std::uint8_t>(data.begin(), data.begin() + 20));
+    EXPECT_EQ(1, data[20]);
+
+    request = {2};
+    result = ValidateReply(mtdPartitions(request, &hMock));
+    EXPECT_EQ(sizeof(MtdPartitionsReply) + sizeof(MtdPartitionsRecord) + 16,
+              result.second.size());
+    EXPECT_EQ(0, result.second[0]);
+    EXPECT_EQ(1, result.second[2]);
+    EXPECT_EQ(2, result.second[3]);
+
+    request = {3};
+    EXPECT_EQ(::ipmi::responseParmOutOfRange(), mtdPartitions(request, &hMock));
+}
+
+TEST(FlashDigestCommandTest, RequestTooSmall)
+{
+    std::vector<std::uint8_t> request = {1};
+
+    HandlerMock hMock;
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              flashDigest(request, &hMock));
+}
+
+TEST(FlashDigestCommandTest, Pending)
+{
+    std::vector<std::uint8_t> request = {2, flashDigestRescan};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getFlashDigest(2, true))
+        .WillOnce(Return(std::optional<Sha256>()));
+
+    auto result = ValidateReply(flashDigest(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysFlashFullDigest, result.first);
+    EXPECT_EQ(std::vector<std::uint8_t>{flashDigestPending}, result.second);
+}
+
+TEST(FlashDigestCommandTest, Ready)
+{
+    std::vector<std::uint8_t> request = {2, 0};
+    Sha256 digest;
+    for (size_t i = 0; i < digest.size(); ++i)
+    {
+        digest[i] = i;
+    }
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getFlashDigest(2, false)).WillOnce(Return(digest));
+
+    auto result = ValidateReply(flashDigest(request, &hMock));
+    auto& data = result.second;
+    ASSERT_EQ(1 + digest.size(), data.size());
+    EXPECT_EQ(flashDigestReady, data[0]);
+    EXPECT_TRUE(std::equal(digest.begin(), digest.end(), data.begin() + 1));
+}
+
+TEST(FlashDigestCommandTest, HandlerErrorIsReturned)
+{
+    std::vector<std::uint8_t> request = {9, 0};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getFlashDigest(9, false))
+        .WillOnce(Return(std::unexpected(::ipmi::ccInvalidFieldRequest)));
+
+    EXPECT_EQ(::ipmi::response(::ipmi::ccInvalidFieldRequest),
+              flashDigest(request, &hMock));
+}
+
 } // namespace ipmi
 } // namespace google
@@ -206,7 +206,7 @@ TEST(GoogleAccelOobTest, Write_Success)
                                               kTestDeviceNameLength);
     EXPECT_CALL(h, accelOobWrite(kTestDeviceNameStr, kTestAddress,
                                  kTestWriteSize, kTestData))
-        .WillOnce(Return());
+        .WillOnce(Return(Result<void>{}));
 
     Request reqBuf{kTestDeviceNameLength, "",       kTestToken, kTestAddress,
                    kTestWriteSize,        kTestData};
@@ -246,7 +246,7 @@ TEST(GoogleAccelOobTest, SetVrSettings_Success)
     std::vector<uint8_t> testData = {kChipId, kSettingsId, 0xBB, 0xAA};
 
     EXPECT_CALL(h, accelSetVrSettings(_, kChipId, kSettingsId, kTestValue))
-        .WillOnce(Return());
+        .WillOnce(Return(Result<void>{}));
 
     Resp r = accelSetVrSettings(nullptr, testData, &h);
 
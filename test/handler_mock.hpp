@@ -18,8 +18,10 @@
 
 #include <ipmid/message.hpp>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -38,42 +40,62 @@ class HandlerMock : public HandlerInterface
     ~HandlerMock() = default;
 
     MOCK_METHOD((std::tuple<std::uint8_t, std::string>), getEthDetails,
-                (std::string), (const, override));
-    MOCK_METHOD(std::int64_t, getRxPackets, (const std::string&),
+                (std::string_view), (override));
+    MOCK_METHOD((std::vector<std::tuple<std::uint8_t, std::string>>),
+                getEthDevices, (), (override));
+    MOCK_METHOD(Result<std::int64_t>, getRxPackets, (const std::string&),
                 (const, override));
-    MOCK_METHOD(
-        (std::tuple<std::uint8_t, std::uint8_t, std::uint8_t, std::uint8_t>),
-        getCpldVersion, (unsigned int), (const, override));
+    MOCK_METHOD(Result<std::vector<LinkStatus>>, getLinkStatuses, (bool),
+                (override));
+    MOCK_METHOD(Result<VersionTuple>, getCpldVersion, (unsigned int),
+                (override));
+    MOCK_METHOD((std::vector<std::tuple<std::uint8_t, VersionTuple>>),
+                getCpldVersions, (), (override));
 
     MOCK_METHOD(void, psuResetDelay, (std::uint32_t), (const, override));
     MOCK_METHOD(void, psuResetOnShutdown, (), (const, override));
     MOCK_METHOD(std::uint32_t, getFlashSize, (), (override));
-    MOCK_METHOD(std::string, getEntityName, (std::uint8_t, std::uint8_t),
+    MOCK_METHOD(Result<std::vector<MtdPartition>>, getMtdPartitions, (),
                 (override));
+    MOCK_METHOD(Result<std::optional<Sha256>>, getFlashDigest,
+                (std::uint8_t, bool), (override));
+    MOCK_METHOD(Result<std::string>, getEntityName,
+                (std::uint8_t, std::uint8_t), (override));
+    MOCK_METHOD(Result<std::shared_ptr<const EntityNameIndex>>,
+                getEntityNameIndex, (), (override));
     MOCK_METHOD(std::string, getMachineName, (), (override));
-    MOCK_METHOD(void, buildI2cPcieMapping, (), (override));
-    MOCK_METHOD(size_t, getI2cPcieMappingSize, (), (const, override));
-    MOCK_METHOD((std::tuple<std::uint32_t, std::string>), getI2cEntry,
-                (unsigned int), (const, override));
+    MOCK_METHOD(std::shared_ptr<const PcieSlotSnapshot>, buildI2cPcieMapping,
+                (), (override));
+    MOCK_METHOD(std::shared_ptr<const PcieSlotSnapshot>, getI2cPcieMapping,
+                (std::uint8_t), (const, override));
     MOCK_METHOD(void, hostPowerOffDelay, (std::uint32_t), (const, override));
 
-    MOCK_METHOD(uint32_t, accelOobDeviceCount, (), (const, override));
-    MOCK_METHOD(std::string, accelOobDeviceName, (size_t), (const, override));
-    MOCK_METHOD(uint64_t, accelOobRead, (std::string_view, uint64_t, uint8_t),
+    MOCK_METHOD(Result<uint32_t>, accelOobDeviceCount, (), (const, override));
+    MOCK_METHOD(Result<std::string>, accelOobDeviceName, (size_t),
                 (const, override));
-    MOCK_METHOD(void, accelOobWrite,
+    MOCK_METHOD(Result<uint64_t>, accelOobRead,
+                (std::string_view, uint64_t, uint8_t), (const, override));
+    MOCK_METHOD(Result<void>, accelOobWrite,
                 (std::string_view, uint64_t, uint8_t, uint64_t),
                 (const, override));
     MOCK_METHOD(std::vector<uint8_t>, pcieBifurcation, (uint8_t), (override));
+    MOCK_METHOD(
+        (std::vector<std::tuple<std::uint8_t, std::vector<std::uint8_t>>>),
+        pcieBifurcations, (), (override));
     MOCK_METHOD(uint8_t, getBmcMode, (), (override));
-    MOCK_METHOD(void, linuxBootDone, (), (const, override));
-    MOCK_METHOD(void, accelSetVrSettings,
+    MOCK_METHOD(uint8_t, waitBmcModeChange,
+                (::ipmi::Context::ptr, uint8_t, std::chrono::milliseconds),
+                (override));
+    MOCK_METHOD(void, linuxBootDone, (), (override));
+    MOCK_METHOD(Result<void>, accelSetVrSettings,
                 (::ipmi::Context::ptr, uint8_t, uint8_t, uint16_t),
                 (const, override));
-    MOCK_METHOD(uint16_t, accelGetVrSettings,
+    MOCK_METHOD(Result<uint16_t>, accelGetVrSettings,
                 (::ipmi::Context::ptr, uint8_t, uint8_t), (const, override));
-    MOCK_METHOD(std::string, getBMInstanceProperty, (uint8_t),
-                (const, override));
+    MOCK_METHOD(Result<std::string>, getBMInstanceProperty, (uint8_t),
+                (override));
+    MOCK_METHOD((std::vector<std::tuple<uint8_t, std::string>>),
+                getBMInstanceProperties, (bool), (override));
     MOCK_METHOD(std::optional<uint16_t>, getCoreCount,
                 (const std::string& filePath), (const, override));
 };
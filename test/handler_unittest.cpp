@@ -13,23 +13,40 @@
 // limitations under the License.
 
 #include "errors.hpp"
+#include "file_reader_mock.hpp"
 #include "handler.hpp"
 #include "handler_impl.hpp"
 
 #include <systemd/sd-bus.h>
 
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <nlohmann/json.hpp>
 #include <sdbusplus/message.hpp>
 #include <sdbusplus/test/sdbus_mock.hpp>
+#include <stdplus/gtest/tmp.hpp>
 #include <stdplus/print.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <charconv>
+#include <chrono>
+#include <expected>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -52,7 +69,99 @@ TEST(HandlerTest, EthCheckValidHappy)
 TEST(HandlerTest, CableCheckIllegalPath)
 {
     Handler h;
-    EXPECT_THROW(h.getRxPackets("eth0/../../"), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidFieldRequest),
+              h.getRxPackets("eth0/../../"));
+}
+
+TEST(HandlerTest, CableCheckMissingInterface)
+{
+    Handler h;
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidFieldRequest),
+              h.getRxPackets("no-such-interface"));
+}
+
+class MockReaderHandler : public Handler
+{
+  public:
+    explicit MockReaderHandler(const fs::path& runDir = "/nonexistent") :
+        runDir(runDir)
+    {}
+
+    FileReaderMock reader;
+
+  protected:
+    const FileReaderInterface& getFileReader() const override
+    {
+        return reader;
+    }
+
+    fs::path getRunDir() const override
+    {
+        return runDir;
+    }
+
+  private:
+    fs::path runDir;
+};
+
+// Read data into the buffer, as FileReaderInterface::read().
+auto readReturns(std::string data)
+{
+    return [data](const std::string&,
+                  std::span<char> buf) -> std::expected<size_t, int> {
+        size_t len = std::min(data.size(), buf.size());
+        std::copy_n(data.begin(), len, buf.begin());
+        return len;
+    };
+}
+
+TEST(HandlerTest, CableRxPacketsRead)
+{
+    MockReaderHandler h;
+    EXPECT_CALL(h.reader, read("/sys/class/net/eth0/statistics/rx_packets", _))
+        .WillOnce(readReturns("42\n"))
+        .WillOnce(Return(std::unexpected(EIO)))
+        .WillOnce(readReturns("x\n"));
+    EXPECT_EQ(42, h.getRxPackets("eth0"));
+    EXPECT_EQ(std::unexpected(::ipmi::ccUnspecifiedError),
+              h.getRxPackets("eth0"));
+    EXPECT_EQ(std::unexpected(::ipmi::ccUnspecifiedError),
+              h.getRxPackets("eth0"));
+}
+
+TEST(HandlerTest, CpldVersionReadWithoutWatch)
+{
+    // Without a run directory to watch, the one file asked for is read.
+    MockReaderHandler h;
+    EXPECT_CALL(h.reader, read("/nonexistent/cpld4.version", _))
+        .WillOnce(readReturns("1.2.3.4\n"));
+    EXPECT_CALL(h.reader, read("/nonexistent/cpld5.version", _))
+        .WillOnce(Return(std::unexpected(ENOENT)));
+    EXPECT_EQ(std::make_tuple(1, 2, 3, 4), h.getCpldVersion(4));
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidFieldRequest),
+              h.getCpldVersion(5));
+}
+
+class CpldVersionTest : public stdplus::gtest::TestWithTmp
+{
+  protected:
+    fs::path runDir = CaseTmpDir();
+    MockReaderHandler h{runDir};
+};
+
+TEST_F(CpldVersionTest, VersionsOfListedFilesRead)
+{
+    std::ofstream(runDir / "cpld4.version");
+    std::ofstream(runDir / "cpld01.version");
+    EXPECT_CALL(h.reader, read((runDir / "cpld4.version").string(), _))
+        .WillOnce(readReturns("1.2.3.4\n"));
+
+    std::vector<std::tuple<std::uint8_t, VersionTuple>> expected = {
+        {4, {1, 2, 3, 4}}};
+    EXPECT_EQ(expected, h.getCpldVersions());
+    EXPECT_EQ(std::make_tuple(1, 2, 3, 4), h.getCpldVersion(4));
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidFieldRequest),
+              h.getCpldVersion(1));
 }
 
 TEST(HandlerTest, readNameFromConfigInstanceVariety)
@@ -88,6 +197,18 @@ TEST(HandlerTest, readNameFromConfigInstanceVariety)
     }
 }
 
+TEST(HandlerTest, EthDevicesAreValidLanChannels)
+{
+    Handler h;
+    std::vector<std::tuple<std::uint8_t, std::string>> expected = {
+        {1, "eth0"}, {2, "eth1"}, {10, "usb0"}};
+    EXPECT_EQ(expected, h.getEthDevices());
+
+    std::tuple<std::uint8_t, std::string> result = h.getEthDetails("eth1");
+    EXPECT_EQ(2, std::get<0>(result));
+    EXPECT_EQ("eth1", std::get<1>(result));
+}
+
 // TODO: If we can test with phosphor-logging in the future, there are more
 // failure cases.
 
@@ -101,7 +222,8 @@ TEST(HandlerTest, getEntityNameWithNameNotFoundExcepts)
     outputJson.close();
 
     Handler h(testFilename);
-    EXPECT_THROW(h.getEntityName(0x03, 2), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidFieldRequest),
+              h.getEntityName(0x03, 2));
     (void)std::remove(testFilename);
 }
 
@@ -115,10 +237,107 @@ TEST(HandlerTest, getEntityNameWithNameFoundReturnsIt)
     outputJson.close();
 
     Handler h(testFilename);
-    EXPECT_STREQ("CPU0", h.getEntityName(0x03, 1).c_str());
+    EXPECT_EQ("CPU0", h.getEntityName(0x03, 1));
     (void)std::remove(testFilename);
 }
 
+TEST(HandlerTest, getEntityNameReloadsChangedConfig)
+{
+    const char* testFilename = "test_reload.json";
+    const char* tmpFilename = "test_reload.json.tmp";
+    auto writeConfig = [](const char* path, const char* name) {
+        std::ofstream outputJson(path);
+        outputJson << std::format(
+            R"({{"cpu": [{{"instance": 1, "name": "{}"}}]}})", name);
+    };
+    writeConfig(testFilename, "CPU0");
+
+    Handler h(testFilename);
+    EXPECT_EQ("CPU0", h.getEntityName(0x03, 1));
+
+    // Replace the file the way generators do, and wait for the new index.
+    writeConfig(tmpFilename, "CPU_NEW");
+    ASSERT_EQ(0, std::rename(tmpFilename, testFilename));
+    Result<std::string> name;
+    for (int i = 0; i < 500; ++i)
+    {
+        name = h.getEntityName(0x03, 1);
+        if (name != "CPU0")
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ("CPU_NEW", name);
+
+    // A broken rewrite keeps the last good index: until a good rewrite after
+    // it is seen, the name stays the last good one.
+    {
+        std::ofstream outputJson(testFilename);
+        outputJson << "{";
+    }
+    writeConfig(tmpFilename, "CPU_SENTINEL");
+    ASSERT_EQ(0, std::rename(tmpFilename, testFilename));
+    for (int i = 0; i < 500; ++i)
+    {
+        name = h.getEntityName(0x03, 1);
+        if (name != "CPU_NEW")
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ("CPU_SENTINEL", name);
+    (void)std::remove(testFilename);
+}
+
+TEST(HandlerTest, getEntityNameReloadsAfterDirectoryRecreated)
+{
+    const char* testDir = "test_reload_dir";
+    std::string testFilename = std::format("{}/config.json", testDir);
+    auto writeConfig = [&](const char* name) {
+        std::ofstream outputJson(testFilename);
+        outputJson << std::format(
+            R"({{"cpu": [{{"instance": 1, "name": "{}"}}]}})", name);
+    };
+    fs::remove_all(testDir);
+    fs::create_directory(testDir);
+    writeConfig("CPU0");
+
+    Handler h(testFilename);
+    EXPECT_EQ("CPU0", h.getEntityName(0x03, 1));
+
+    // Dropping the directory drops its watch; the watch is added again once
+    // the directory is back, and later changes are still seen.
+    fs::remove_all(testDir);
+    fs::create_directory(testDir);
+    writeConfig("CPU_NEW");
+    Result<std::string> name;
+    for (int i = 0; i < 500; ++i)
+    {
+        name = h.getEntityName(0x03, 1);
+        if (name == "CPU_NEW")
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ("CPU_NEW", name);
+
+    writeConfig("CPU_NEWER");
+    for (int i = 0; i < 500; ++i)
+    {
+        name = h.getEntityName(0x03, 1);
+        if (name == "CPU_NEWER")
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ("CPU_NEWER", name);
+    fs::remove_all(testDir);
+}
+
 using ::testing::_;
 using ::testing::AnyNumber;
 using ::testing::ContainerEq;
@@ -327,7 +546,8 @@ TEST(HandlerTest, accelOobDeviceCount_Fail)
     MockDbusHandler h(mock);
     ExpectSdBusError(mock, "com.google.custom_accel", "/",
                      "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
-    EXPECT_THROW(h.accelOobDeviceCount(), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccUnspecifiedError),
+              h.accelOobDeviceCount());
 }
 
 TEST(HandlerTest, accelOobDeviceName_Success)
@@ -344,7 +564,8 @@ TEST(HandlerTest, accelOobDeviceName_Fail)
     MockDbusHandler h(mock);
     ExpectSdBusError(mock, "com.google.custom_accel", "/",
                      "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
-    EXPECT_THROW(h.accelOobDeviceName(0), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccUnspecifiedError),
+              h.accelOobDeviceName(0));
 }
 
 TEST(HandlerTest, accelOobDeviceName_OutOfRange)
@@ -352,7 +573,8 @@ TEST(HandlerTest, accelOobDeviceName_OutOfRange)
     StrictMock<sdbusplus::SdBusMock> mock;
     MockDbusHandler h(mock);
     ExpectGetManagedObjects(mock);
-    EXPECT_THROW(h.accelOobDeviceName(1), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccParmOutOfRange),
+              h.accelOobDeviceName(1));
 }
 
 TEST(HandlerTest, accelOobDeviceName_InvalidName)
@@ -361,7 +583,8 @@ TEST(HandlerTest, accelOobDeviceName_InvalidName)
     StrictMock<sdbusplus::SdBusMock> mock;
     MockDbusHandler h(mock);
     ExpectGetManagedObjects(mock, bad_object_path);
-    EXPECT_THROW(h.accelOobDeviceName(0), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidCommand),
+              h.accelOobDeviceName(0));
 }
 
 constexpr uint8_t NUM_BYTES_RETURNED_EQ_NUM_BYTES = 0xff;
@@ -458,8 +681,8 @@ TEST(HandlerTest, accelOobRead_Fail)
     constexpr uint64_t data = 0x13579bdf02468ace;
 
     ExpectRead(mock, address, num_bytes, data, sd_bus_call_return_value);
-    EXPECT_THROW(h.accelOobRead("test/path", address, num_bytes),
-                 IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccUnspecifiedError),
+              h.accelOobRead("test/path", address, num_bytes));
 }
 
 TEST(HandlerTest, accelOobRead_TooFewBytesReturned)
@@ -475,8 +698,8 @@ TEST(HandlerTest, accelOobRead_TooFewBytesReturned)
 
     ExpectRead(mock, address, num_bytes, data, sd_bus_call_return_value,
                num_bytes_returned);
-    EXPECT_THROW(h.accelOobRead("test/path", address, num_bytes),
-                 IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccUnspecifiedError),
+              h.accelOobRead("test/path", address, num_bytes));
 }
 
 TEST(HandlerTest, accelOobRead_TooManyBytesReturned)
@@ -492,8 +715,8 @@ TEST(HandlerTest, accelOobRead_TooManyBytesReturned)
 
     ExpectRead(mock, address, num_bytes, data, sd_bus_call_return_value,
                num_bytes_returned);
-    EXPECT_THROW(h.accelOobRead("test/path", address, num_bytes),
-                 IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccReqDataTruncated),
+              h.accelOobRead("test/path", address, num_bytes));
 }
 
 static int on_array_append(sd_bus_message*, char, const void*, size_t)
@@ -552,7 +775,7 @@ TEST(HandlerTest, accelOobWrite_Success)
     constexpr uint64_t data = 0x13579bdf02468ace;
 
     ExpectWrite(mock, address, num_bytes, data, sd_bus_call_return_value);
-    EXPECT_NO_THROW(h.accelOobWrite("test/path", address, num_bytes, data));
+    EXPECT_TRUE(h.accelOobWrite("test/path", address, num_bytes, data));
 }
 
 TEST(HandlerTest, accelOobRead_TooManyBytesRequested)
@@ -564,8 +787,8 @@ TEST(HandlerTest, accelOobRead_TooManyBytesRequested)
     constexpr uint8_t num_bytes = sizeof(uint64_t) + 1;
     constexpr uint64_t data = 0x13579bdf02468ace;
 
-    EXPECT_THROW(h.accelOobWrite("test/path", address, num_bytes, data),
-                 IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccParmOutOfRange),
+              h.accelOobWrite("test/path", address, num_bytes, data));
 }
 
 TEST(HandlerTest, accelOobWrite_Fail)
@@ -579,8 +802,19 @@ TEST(HandlerTest, accelOobWrite_Fail)
     constexpr uint64_t data = 0x13579bdf02468ace;
 
     ExpectWrite(mock, address, num_bytes, data, sd_bus_call_return_value);
-    EXPECT_THROW(h.accelOobWrite("test/path", address, num_bytes, data),
-                 IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccUnspecifiedError),
+              h.accelOobWrite("test/path", address, num_bytes, data));
+}
+
+TEST(HandlerTest, accelVrSettings_UnknownSettingsId)
+{
+    Handler h;
+
+    // Rejected before the ipmid context is used.
+    EXPECT_EQ(std::unexpected(::ipmi::ccParmOutOfRange),
+              h.accelGetVrSettings(nullptr, 0, 0xff));
+    EXPECT_EQ(std::unexpected(::ipmi::ccParmOutOfRange),
+              h.accelSetVrSettings(nullptr, 0, 0xff, 0));
 }
 
 TEST(HandlerTest, PcieBifurcation)
@@ -627,16 +861,40 @@ TEST(HandlerTest, PcieBifurcation)
     }
 }
 
+TEST(HandlerTest, PcieBifurcationReparsedOnChange)
+{
+    const std::string& testJson = "/tmp/test-json-reparse";
+    std::ofstream(testJson) << R"({"2": [ 8, 8 ], "300": [ 1 ], "02": [ 4 ]})";
+
+    BifurcationStatic bifurcationHelper(testJson);
+    Handler h(std::ref(bifurcationHelper));
+    EXPECT_THAT(h.pcieBifurcation(2), ContainerEq(std::vector<uint8_t>{8, 8}));
+    EXPECT_TRUE(h.pcieBifurcation(44).empty());
+    EXPECT_EQ((std::vector<std::tuple<std::uint8_t, std::vector<std::uint8_t>>>{
+                  {2, {8, 8}}}),
+              h.pcieBifurcations());
+
+    std::ofstream(testJson) << R"({"2": [ 4, 4, 4, 4 ], "7": "x"})";
+    EXPECT_THAT(h.pcieBifurcation(2),
+                ContainerEq(std::vector<uint8_t>{4, 4, 4, 4}));
+    EXPECT_TRUE(h.pcieBifurcation(7).empty());
+
+    std::filesystem::remove(testJson);
+    EXPECT_TRUE(h.pcieBifurcation(2).empty());
+}
+
 TEST(HandlerTest, BmInstanceFailCase)
 {
     StrictMock<sdbusplus::SdBusMock> mock;
     MockDbusHandler h(mock);
 
     // Invalid enum
-    EXPECT_THROW(h.getBMInstanceProperty(0x07), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidFieldRequest),
+              h.getBMInstanceProperty(0x07));
 
     // Valid enum but no path exists
-    EXPECT_THROW(h.getBMInstanceProperty(0x00), IpmiException);
+    EXPECT_EQ(std::unexpected(::ipmi::ccInvalidFieldRequest),
+              h.getBMInstanceProperty(0x00));
 }
 
 TEST(HandlerTest, GetCoreCountFileDoesNotExist)
@@ -722,6 +980,190 @@ TEST(HandlerTest, GetCoreCountWithExtraKeys)
     std::remove(testFilename);
 }
 
+// Reads and writes the BMC mode flag files under a directory instead of /.
+class RootedFs : public FileSystemInterface
+{
+  public:
+    explicit RootedFs(const fs::path& root) : root(root) {}
+
+    bool exists(const fs::path& path, std::error_code& ec) const override
+    {
+        return fs::exists(root / path.relative_path(), ec);
+    }
+
+    void rename(const fs::path& oldPath, const fs::path& newPath,
+                std::error_code& ec) const override
+    {
+        fs::rename(root / oldPath.relative_path(),
+                   root / newPath.relative_path(), ec);
+    }
+
+    void create(const char* path) const override
+    {
+        std::ofstream(root / fs::path(path).relative_path());
+    }
+
+  private:
+    fs::path root;
+};
+
+class RootedBmcModeHandler : public Handler
+{
+  public:
+    explicit RootedBmcModeHandler(const fs::path& root) :
+        root(root), rootedFs(std::make_unique<RootedFs>(root))
+    {}
+
+    using Handler::waitBmcModeChange;
+
+  protected:
+    const std::unique_ptr<FileSystemInterface>& getFs() const override
+    {
+        return rootedFs;
+    }
+
+    std::vector<std::string> getBmcModeFlagPaths() const override
+    {
+        auto paths = Handler::getBmcModeFlagPaths();
+        for (auto& path : paths)
+        {
+            path = root / fs::path(path).relative_path();
+        }
+        return paths;
+    }
+
+  private:
+    fs::path root;
+    std::unique_ptr<FileSystemInterface> rootedFs;
+};
+
+class BmcModeWaitTest : public stdplus::gtest::TestWithTmp
+{
+  protected:
+    struct Waited
+    {
+        uint8_t mode;
+        std::chrono::steady_clock::duration took;
+    };
+
+    void SetUp() override
+    {
+        if (BARE_METAL)
+        {
+            GTEST_SKIP() << "The BMC mode never changes on bare metal";
+        }
+        for (const auto& path : flagPaths())
+        {
+            fs::create_directories(path.parent_path());
+        }
+    }
+
+    std::vector<fs::path> flagPaths() const
+    {
+        std::vector<fs::path> paths;
+        for (const auto& path :
+             {bmDriveCleaningDoneAckFlagPath, bmDriveCleaningDoneFlagPath,
+              BM_SIGNAL_PATH})
+        {
+            paths.push_back(root / fs::path(path).relative_path());
+        }
+        return paths;
+    }
+
+    // Wait in a coroutine on io, as a request would.
+    void wait(uint8_t lastMode, std::chrono::milliseconds timeout,
+              std::optional<Waited>& waited)
+    {
+        boost::asio::spawn(
+            io,
+            [this, lastMode, timeout,
+             &waited](boost::asio::yield_context yield) {
+                auto start = std::chrono::steady_clock::now();
+                uint8_t mode = h.waitBmcModeChange(io, yield, lastMode,
+                                                    timeout);
+                waited = Waited{mode, std::chrono::steady_clock::now() - start};
+            },
+            boost::asio::detached);
+    }
+
+    // Raise the BM signal flag from io once delay has passed.
+    void signalAfter(std::chrono::milliseconds delay)
+    {
+        auto timer = std::make_shared<boost::asio::steady_timer>(io, delay);
+        timer->async_wait([this, timer](const boost::system::error_code&) {
+            for (const auto& path : flagPaths())
+            {
+                fs::create_directories(path.parent_path());
+            }
+            std::ofstream(root / fs::path(BM_SIGNAL_PATH).relative_path());
+        });
+    }
+
+    fs::path root = CaseTmpDir();
+    RootedBmcModeHandler h{root};
+    boost::asio::io_context io;
+};
+
+TEST_F(BmcModeWaitTest, FlagChangeWakesWaiter)
+{
+    std::optional<Waited> waited;
+    wait(static_cast<uint8_t>(BmcMode::NON_BM_MODE), std::chrono::seconds(10),
+         waited);
+    signalAfter(std::chrono::milliseconds(100));
+    io.run();
+
+    ASSERT_TRUE(waited);
+    EXPECT_EQ(static_cast<uint8_t>(BmcMode::BM_CLEANING_MODE), waited->mode);
+    // Woken by the watcher, well before the one second re-check.
+    EXPECT_LT(waited->took, std::chrono::milliseconds(800));
+}
+
+TEST_F(BmcModeWaitTest, UnwatchedFlagsAreCheckedEverySecond)
+{
+    // With the flag directories gone, the flags cannot be watched.
+    for (const auto& path : flagPaths())
+    {
+        fs::remove_all(path.parent_path());
+    }
+
+    std::optional<Waited> waited;
+    wait(static_cast<uint8_t>(BmcMode::NON_BM_MODE), std::chrono::seconds(10),
+         waited);
+    signalAfter(std::chrono::milliseconds(100));
+    io.run();
+
+    ASSERT_TRUE(waited);
+    EXPECT_EQ(static_cast<uint8_t>(BmcMode::BM_CLEANING_MODE), waited->mode);
+    EXPECT_GE(waited->took, std::chrono::milliseconds(900));
+    EXPECT_LT(waited->took, std::chrono::seconds(5));
+}
+
+TEST_F(BmcModeWaitTest, WaitersPastTheLimitAnswerAtOnce)
+{
+    // Eight waiters are held to the timeout; the ninth is not held.
+    std::array<std::optional<Waited>, 9> waited;
+    for (auto& one : waited)
+    {
+        wait(static_cast<uint8_t>(BmcMode::NON_BM_MODE),
+             std::chrono::milliseconds(300), one);
+    }
+    io.run();
+
+    for (size_t i = 0; i < waited.size(); ++i)
+    {
+        ASSERT_TRUE(waited[i]);
+        EXPECT_EQ(static_cast<uint8_t>(BmcMode::NON_BM_MODE), waited[i]->mode);
+        if (i < 8)
+        {
+            EXPECT_GE(waited[i]->took, std::chrono::milliseconds(300));
+        }
+        else
+        {
+            EXPECT_LT(waited[i]->took, std::chrono::milliseconds(100));
+        }
+    }
+}
+
 // TODO: Add checks for other functions of handler.
 
 } // namespace ipmi
@@ -0,0 +1,157 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "inotify_watcher.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdplus/gtest/tmp.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+class InotifyWatcherTest : public stdplus::gtest::TestWithTmp
+{
+  public:
+    std::string filename = std::format("{}/watched", CaseTmpDir());
+    std::string otherFilename = std::format("{}/other", CaseTmpDir());
+
+    static void writeFile(const std::string& path, const std::string& data)
+    {
+        std::ofstream ofs(path, std::ios::trunc);
+        ofs << data;
+    }
+
+    // Events are delivered on the watcher thread; give it a few seconds.
+    static bool waitFor(const std::atomic<int>& count, int expected)
+    {
+        for (int i = 0; i < 500 && count < expected; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return count >= expected;
+    }
+};
+
+TEST_F(InotifyWatcherTest, MissingDirectoryFails)
+{
+    InotifyWatcher watcher;
+    EXPECT_FALSE(
+        watcher.watch(std::format("{}/none/file", CaseTmpDir()), [] {}));
+}
+
+TEST_F(InotifyWatcherTest, WriteAndRenameAreSeen)
+{
+    writeFile(filename, "");
+    std::atomic<int> count = 0;
+    InotifyWatcher watcher;
+    ASSERT_TRUE(watcher.watch(filename, [&] { ++count; }));
+
+    writeFile(filename, "one");
+    EXPECT_TRUE(waitFor(count, 1));
+
+    writeFile(otherFilename, "two");
+    ASSERT_EQ(0, std::rename(otherFilename.c_str(), filename.c_str()));
+    EXPECT_TRUE(waitFor(count, 2));
+
+    ASSERT_EQ(0, std::remove(filename.c_str()));
+    EXPECT_TRUE(waitFor(count, 3));
+}
+
+TEST_F(InotifyWatcherTest, OtherFilesAreIgnored)
+{
+    std::atomic<int> count = 0;
+    std::atomic<int> otherCount = 0;
+    InotifyWatcher watcher;
+    ASSERT_TRUE(watcher.watch(filename, [&] { ++count; }));
+    ASSERT_TRUE(watcher.watch(otherFilename, [&] { ++otherCount; }));
+
+    writeFile(otherFilename, "data");
+    EXPECT_TRUE(waitFor(otherCount, 1));
+    EXPECT_EQ(0, count);
+}
+
+TEST_F(InotifyWatcherTest, PatternMatchesFiles)
+{
+    // Created first, so each write below is a single event.
+    std::string wanted = std::format("{}/wanted", CaseTmpDir());
+    writeFile(filename, "");
+    writeFile(otherFilename, "");
+    writeFile(wanted, "");
+
+    std::atomic<int> count = 0;
+    InotifyWatcher watcher;
+    ASSERT_TRUE(watcher.watch(std::format("{}/w*ed", CaseTmpDir()),
+                              [&] { ++count; }));
+
+    writeFile(filename, "one");
+    EXPECT_TRUE(waitFor(count, 1));
+
+    writeFile(otherFilename, "two");
+    writeFile(wanted, "three");
+    EXPECT_TRUE(waitFor(count, 2));
+    EXPECT_EQ(2, count);
+}
+
+TEST_F(InotifyWatcherTest, LinkIsSeen)
+{
+    // A hard link, like a device node made by mknod, only creates the name.
+    std::atomic<int> count = 0;
+    writeFile(otherFilename, "data");
+    InotifyWatcher watcher;
+    ASSERT_TRUE(watcher.watch(filename, [&] { ++count; }));
+
+    ASSERT_EQ(0, ::link(otherFilename.c_str(), filename.c_str()));
+    EXPECT_TRUE(waitFor(count, 1));
+}
+
+TEST_F(InotifyWatcherTest, DeletedDirectoryIsLost)
+{
+    std::atomic<int> count = 0;
+    std::atomic<int> lost = 0;
+    std::string dir = std::format("{}/dir", CaseTmpDir());
+    std::string file = std::format("{}/watched", dir);
+    ASSERT_EQ(0, ::mkdir(dir.c_str(), 0755));
+    InotifyWatcher watcher;
+    ASSERT_TRUE(watcher.watch(file, [&] { ++count; }, [&] { ++lost; }));
+
+    ASSERT_EQ(0, ::rmdir(dir.c_str()));
+    EXPECT_TRUE(waitFor(lost, 1));
+    EXPECT_EQ(1, count);
+
+    // Nothing is seen through the dropped watch, but it can be watched again.
+    ASSERT_EQ(0, ::mkdir(dir.c_str(), 0755));
+    writeFile(file, "one");
+    ASSERT_TRUE(watcher.watch(file, [&] { count += 10; }));
+    writeFile(file, "two");
+    EXPECT_TRUE(waitFor(count, 11));
+    EXPECT_EQ(11, count);
+    EXPECT_EQ(1, lost);
+}
+
+} // namespace ipmi
+} // namespace google
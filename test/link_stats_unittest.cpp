@@ -0,0 +1,149 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "link_stats.hpp"
+
+#include <linux/if.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+// Builds an RTM_NEWLINK message one attribute at a time.
+class LinkMessage
+{
+  public:
+    LinkMessage(int index, unsigned flags,
+                std::uint16_t type = RTM_NEWLINK) :
+        buf(NLMSG_SPACE(sizeof(ifinfomsg)))
+    {
+        ifinfomsg info{};
+        info.ifi_index = index;
+        info.ifi_flags = flags;
+        std::memcpy(buf.data() + NLMSG_HDRLEN, &info, sizeof(info));
+        header().nlmsg_type = type;
+    }
+
+    LinkMessage& add(std::uint16_t type, const void* data, size_t len)
+    {
+        size_t offset = buf.size();
+        buf.resize(offset + RTA_SPACE(len));
+        rtattr attr{static_cast<std::uint16_t>(RTA_LENGTH(len)), type};
+        std::memcpy(buf.data() + offset, &attr, sizeof(attr));
+        std::memcpy(buf.data() + offset + RTA_LENGTH(0), data, len);
+        return *this;
+    }
+
+    const nlmsghdr* get()
+    {
+        header().nlmsg_len = buf.size();
+        return &header();
+    }
+
+  private:
+    nlmsghdr& header()
+    {
+        return *reinterpret_cast<nlmsghdr*>(buf.data());
+    }
+
+    std::vector<char> buf;
+};
+
+TEST(LinkStatsTest, ParsesNameStateAndStats64)
+{
+    rtnl_link_stats stats32{};
+    stats32.rx_packets = 1;
+    rtnl_link_stats64 stats64{};
+    stats64.rx_packets = 0x1'0000'0001;
+    stats64.tx_packets = 7;
+    std::uint8_t operState = IF_OPER_UP;
+
+    LinkMessage message(2, IFF_LOWER_UP);
+    message.add(IFLA_IFNAME, "eth0", 5)
+        .add(IFLA_OPERSTATE, &operState, sizeof(operState))
+        .add(IFLA_STATS64, &stats64, sizeof(stats64))
+        .add(IFLA_STATS, &stats32, sizeof(stats32));
+
+    auto link = parseLinkMessage(message.get());
+    ASSERT_TRUE(link);
+    EXPECT_EQ(2, link->index);
+    EXPECT_EQ("eth0", link->name);
+    EXPECT_EQ(IFF_LOWER_UP, link->flags);
+    EXPECT_EQ(IF_OPER_UP, link->operState);
+    EXPECT_EQ(0x1'0000'0001u, link->rxPackets);
+    EXPECT_EQ(7u, link->txPackets);
+}
+
+TEST(LinkStatsTest, FallsBackToStats)
+{
+    rtnl_link_stats stats32{};
+    stats32.rx_packets = 3;
+    stats32.tx_packets = 4;
+
+    LinkMessage message(3, 0);
+    message.add(IFLA_STATS, &stats32, sizeof(stats32))
+        .add(IFLA_IFNAME, "usb0", 5);
+
+    auto link = parseLinkMessage(message.get());
+    ASSERT_TRUE(link);
+    EXPECT_EQ("usb0", link->name);
+    EXPECT_EQ(3u, link->rxPackets);
+    EXPECT_EQ(4u, link->txPackets);
+}
+
+TEST(LinkStatsTest, RejectsMalformed)
+{
+    rtnl_link_stats64 stats64{};
+
+    // No name.
+    LinkMessage unnamed(4, 0);
+    unnamed.add(IFLA_STATS64, &stats64, sizeof(stats64));
+    EXPECT_EQ(std::nullopt, parseLinkMessage(unnamed.get()));
+
+    // Not a link.
+    LinkMessage address(4, 0, RTM_NEWADDR);
+    address.add(IFLA_IFNAME, "eth0", 5);
+    EXPECT_EQ(std::nullopt, parseLinkMessage(address.get()));
+
+    // Truncated stats are ignored.
+    LinkMessage truncated(4, 0);
+    truncated.add(IFLA_IFNAME, "eth0", 5).add(IFLA_STATS64, &stats64, 8);
+    auto link = parseLinkMessage(truncated.get());
+    ASSERT_TRUE(link);
+    EXPECT_EQ(0u, link->rxPackets);
+}
+
+TEST(LinkStatsTest, DumpIncludesLoopback)
+{
+    auto links = dumpLinkStats();
+    ASSERT_TRUE(links) << links.error();
+    EXPECT_TRUE(std::ranges::any_of(*links, [](const LinkStats& link) {
+        return (link.flags & IFF_LOOPBACK) && link.name == "lo";
+    }));
+}
+
+} // namespace ipmi
+} // namespace google
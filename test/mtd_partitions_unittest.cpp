@@ -0,0 +1,56 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mtd_partitions.hpp"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+TEST(MtdPartitionsTest, ParsesProcMtd)
+{
+    std::vector<std::tuple<unsigned int, std::string>> expected = {
+        {0, "bmc"}, {1, "u-boot"}, {12, "image a"}};
+    EXPECT_EQ(expected, parseProcMtd("dev:    size   erasesize  name\n"
+                                     "mtd0: 04000000 00010000 \"bmc\"\n"
+                                     "mtd1: 00060000 00010000 \"u-boot\"\n"
+                                     "mtd12: 02000000 00010000 \"image a\""));
+}
+
+TEST(MtdPartitionsTest, SkipsMalformedLines)
+{
+    std::vector<std::tuple<unsigned int, std::string>> expected = {
+        {3, ""}};
+    EXPECT_EQ(expected, parseProcMtd("mtd: 04000000 00010000 \"bmc\"\n"
+                                     "mtdx: 04000000 00010000 \"bmc\"\n"
+                                     "mtd1 04000000 00010000 \"bmc\"\n"
+                                     "mtd2: 04000000 00010000 \"bmc\n"
+                                     "mtd3: 04000000 00010000 \"\"\n"));
+}
+
+TEST(MtdPartitionsTest, EmptyFile)
+{
+    EXPECT_TRUE(parseProcMtd("").empty());
+    EXPECT_TRUE(parseProcMtd("dev:    size   erasesize  name\n").empty());
+}
+
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,115 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paged_reply.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+struct CountedReply
+{
+    uint8_t more;
+    uint8_t nextEntry;
+    uint8_t recordCount;
+} __attribute__((packed));
+
+struct UncountedReply
+{
+    uint8_t more;
+    uint16_t nextOffset;
+} __attribute__((packed));
+
+struct Record
+{
+    uint8_t id;
+    uint16_t value;
+} __attribute__((packed));
+
+TEST(PagedReplyTest, EmptyPage)
+{
+    PagedReply<CountedReply> page;
+
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 0}), std::move(page).bytes());
+}
+
+TEST(PagedReplyTest, RecordsAreAddedInOrderAndCounted)
+{
+    PagedReply<CountedReply> page;
+    std::vector<std::uint8_t> lanes = {8, 8};
+
+    page.add(Record{1, 0x0203}, std::string("ab"));
+    page.add(std::uint8_t{4}, std::span<const std::uint8_t>(lanes));
+
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 2, 1, 3, 2, 'a', 'b', 4, 8, 8}),
+              std::move(page).bytes());
+}
+
+TEST(PagedReplyTest, FullPageHasMore)
+{
+    using Page = PagedReply<CountedReply>;
+    EXPECT_EQ(MAX_IPMI_BUFFER - 1u - sizeof(CountedReply),
+              Page::maxRecordLength);
+
+    // 20 byte records: three fit after the header in a 63 byte reply.
+    Page page;
+    std::string record(20, 'x');
+    size_t added = 0;
+    while (!page.full(record.size()))
+    {
+        page.add(record);
+        ++added;
+    }
+    page.header.nextEntry = added;
+
+    EXPECT_EQ(3u, added);
+    EXPECT_EQ(1, page.header.more);
+    auto bytes = std::move(page).bytes();
+    EXPECT_EQ(sizeof(CountedReply) + 3 * record.size(), bytes.size());
+    EXPECT_EQ((std::vector<std::uint8_t>{1, 3, 3}),
+              std::vector<std::uint8_t>(bytes.begin(), bytes.begin() + 3));
+}
+
+TEST(PagedReplyTest, RecordThatFillsThePageExactly)
+{
+    using Page = PagedReply<CountedReply>;
+    Page page;
+
+    EXPECT_FALSE(page.full(Page::maxRecordLength));
+    page.add(std::string(Page::maxRecordLength, 'x'));
+    EXPECT_TRUE(page.full(1));
+    EXPECT_EQ(static_cast<size_t>(MAX_IPMI_BUFFER - 1),
+              std::move(page).bytes().size());
+}
+
+TEST(PagedReplyTest, HeaderWithoutRecordCount)
+{
+    PagedReply<UncountedReply> page;
+
+    page.add(std::string("abc"));
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 0, 'a', 'b', 'c'}),
+              std::move(page).bytes());
+}
+
+} // namespace ipmi
+} // namespace google
@@ -17,6 +17,8 @@
 #include "helper.hpp"
 #include "pcie_bifurcation.hpp"
 
+#include <cstdint>
+#include <tuple>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -70,5 +72,61 @@ TEST(PcieBifurcationCommandTest, ReplyExceddedMaxValue)
               pcieBifurcation(request, &hMock));
 }
 
+TEST(PcieBifurcationListCommandTest, InvalidRequest)
+{
+    std::vector<uint8_t> request = {};
+
+    HandlerMock hMock;
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              pcieBifurcationList(request, &hMock));
+}
+
+TEST(PcieBifurcationListCommandTest, AllSlotsInOnePage)
+{
+    std::vector<uint8_t> request = {0};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, pcieBifurcations())
+        .WillOnce(Return(
+            std::vector<std::tuple<std::uint8_t, std::vector<std::uint8_t>>>{
+                {1, {8, 8}}, {4, {16}}, {9, {}}}));
+
+    auto result = ValidateReply(pcieBifurcationList(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysPCIeSlotBifurcationList, result.first);
+    EXPECT_THAT(result.second,
+                ContainerEq(std::vector<uint8_t>{
+                    0, 0, 3, 1, 2, 8, 8, 4, 1, 16, 9, 0}));
+}
+
+TEST(PcieBifurcationListCommandTest, Paged)
+{
+    std::vector<std::tuple<std::uint8_t, std::vector<std::uint8_t>>> slots;
+    for (std::uint8_t index = 0; index < 20; ++index)
+    {
+        slots.emplace_back(index, std::vector<std::uint8_t>{4, 4});
+    }
+    // Too many lanes for any page.
+    slots.emplace_back(30, std::vector<std::uint8_t>(60, 1));
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, pcieBifurcations()).WillRepeatedly(Return(slots));
+
+    // 3 header bytes and 4 bytes per slot fill the 63 byte reply at 15 slots.
+    std::vector<uint8_t> request = {0};
+    auto first = ValidateReply(pcieBifurcationList(request, &hMock)).second;
+    ASSERT_EQ(63u, first.size());
+    EXPECT_EQ(1, first[0]);
+    EXPECT_EQ(15, first[1]);
+    EXPECT_EQ(15, first[2]);
+
+    request = {first[1]};
+    auto second = ValidateReply(pcieBifurcationList(request, &hMock)).second;
+    ASSERT_EQ(23u, second.size());
+    EXPECT_EQ(0, second[0]);
+    EXPECT_EQ(5, second[2]);
+    EXPECT_EQ(15, second[3]);
+    EXPECT_EQ(19, second[19]);
+}
+
 } // namespace ipmi
 } // namespace google
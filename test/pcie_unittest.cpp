@@ -16,14 +16,30 @@
 #include "handler_mock.hpp"
 #include "helper.hpp"
 #include "pcie_i2c.hpp"
+#include "pcie_slot_snapshot.hpp"
+#include "util.hpp"
 
+#include <stdplus/gtest/tmp.hpp>
+
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+#ifndef MAX_IPMI_BUFFER
+#define MAX_IPMI_BUFFER 64
+#endif
+
 using ::testing::Return;
 
 namespace google
@@ -31,14 +47,39 @@ namespace google
 namespace ipmi
 {
 
+using Slots = std::vector<std::tuple<std::uint32_t, std::string>>;
+
+std::shared_ptr<const PcieSlotSnapshot> makeSnapshot(std::uint8_t generation,
+                                                     Slots slots)
+{
+    return std::make_shared<const PcieSlotSnapshot>(
+        PcieSlotSnapshot{generation, std::move(slots)});
+}
+
 TEST(PcieI2cCommandTest, PcieSlotCountTest)
 {
     std::vector<std::uint8_t> request = {};
-    size_t expectedSize = 3;
 
     HandlerMock hMock;
-    EXPECT_CALL(hMock, buildI2cPcieMapping());
-    EXPECT_CALL(hMock, getI2cPcieMappingSize()).WillOnce(Return(expectedSize));
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(7, Slots(3))));
+
+    auto reply = pcieSlotCount(request, &hMock);
+    auto result = ValidateReply(reply);
+    auto& data = result.second;
+
+    // Without flags the reply is only the count, as for older hosts.
+    EXPECT_EQ(SysOEMCommands::SysPcieSlotCount, result.first);
+    EXPECT_EQ(std::vector<std::uint8_t>{3}, data);
+}
+
+TEST(PcieI2cCommandTest, PcieSlotCountWithGenerationTest)
+{
+    std::vector<std::uint8_t> request = {pcieSlotCountWithGeneration};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(7, Slots(3))));
 
     auto reply = pcieSlotCount(request, &hMock);
     auto result = ValidateReply(reply);
@@ -46,7 +87,8 @@ TEST(PcieI2cCommandTest, PcieSlotCountTest)
 
     EXPECT_EQ(sizeof(struct PcieSlotCountReply), data.size());
     EXPECT_EQ(SysOEMCommands::SysPcieSlotCount, result.first);
-    EXPECT_EQ(expectedSize, data[0]);
+    EXPECT_EQ(3, data[0]);
+    EXPECT_EQ(7, data[1]);
 }
 
 TEST(PcieI2cCommandTest, PcieSlotEntryRequestTooShort)
@@ -64,7 +106,18 @@ TEST(PcieI2cCommandTest, PcieSlotEntryRequestUnsupportedByPlatform)
     std::vector<std::uint8_t> request = {0};
 
     HandlerMock hMock;
-    EXPECT_CALL(hMock, getI2cPcieMappingSize()).WillOnce(Return(0));
+    EXPECT_CALL(hMock, getI2cPcieMapping(0))
+        .WillOnce(Return(makeSnapshot(1, {})));
+    EXPECT_EQ(::ipmi::responseInvalidReservationId(),
+              pcieSlotI2cBusMapping(request, &hMock));
+}
+
+TEST(PcieI2cCommandTest, PcieSlotEntryRequestNeverCounted)
+{
+    std::vector<std::uint8_t> request = {0};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getI2cPcieMapping(0)).WillOnce(Return(nullptr));
     EXPECT_EQ(::ipmi::responseInvalidReservationId(),
               pcieSlotI2cBusMapping(request, &hMock));
 }
@@ -75,7 +128,8 @@ TEST(PcieI2cCommandTest, PcieSlotEntryRequestInvalidIndex)
     std::vector<std::uint8_t> request = {1};
 
     HandlerMock hMock;
-    EXPECT_CALL(hMock, getI2cPcieMappingSize()).WillOnce(Return(1));
+    EXPECT_CALL(hMock, getI2cPcieMapping(0))
+        .WillOnce(Return(makeSnapshot(1, Slots(1))));
     EXPECT_EQ(::ipmi::responseParmOutOfRange(),
               pcieSlotI2cBusMapping(request, &hMock));
 }
@@ -88,9 +142,8 @@ TEST(PcieI2cCommandTest, PcieSlotEntryRequestValidIndex)
     std::uint32_t busNum = 5;
 
     HandlerMock hMock;
-    EXPECT_CALL(hMock, getI2cPcieMappingSize()).WillOnce(Return(1));
-    EXPECT_CALL(hMock, getI2cEntry(index))
-        .WillOnce(Return(std::make_tuple(busNum, slotName)));
+    EXPECT_CALL(hMock, getI2cPcieMapping(0))
+        .WillOnce(Return(makeSnapshot(1, {{busNum, slotName}})));
 
     auto reply = pcieSlotI2cBusMapping(request, &hMock);
     auto result = ValidateReply(reply);
@@ -105,5 +158,353 @@ TEST(PcieI2cCommandTest, PcieSlotEntryRequestValidIndex)
                     data.end()));
 }
 
+TEST(PcieI2cCommandTest, PcieSlotEntryRequestEchoesGeneration)
+{
+    // The host counted generation 4; a rebuild since must not change what it
+    // reads.
+    std::vector<std::uint8_t> request = {1, 4};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getI2cPcieMapping(4))
+        .WillOnce(Return(makeSnapshot(4, {{1, "old0"}, {2, "old1"}})));
+
+    auto result = ValidateReply(pcieSlotI2cBusMapping(request, &hMock));
+    auto& data = result.second;
+    EXPECT_EQ(2, data[0]);
+    EXPECT_EQ("old1", std::string(data.begin() + 2, data.end()));
+}
+
+TEST(PcieI2cCommandTest, PcieSlotEntryRequestDroppedGeneration)
+{
+    std::vector<std::uint8_t> request = {0, 4};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getI2cPcieMapping(4)).WillOnce(Return(nullptr));
+    EXPECT_EQ(::ipmi::responseInvalidReservationId(),
+              pcieSlotI2cBusMapping(request, &hMock));
+}
+
+// Walk the records of a SysPcieSlotI2cBusMappingList reply, returning the
+// header and the (bus, name) records.
+std::pair<PcieSlotI2cBusMappingListReply, Slots>
+    parseList(const std::vector<std::uint8_t>& data)
+{
+    PcieSlotI2cBusMappingListReply header;
+    EXPECT_LE(sizeof(header), data.size());
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    Slots records;
+    size_t pos = sizeof(header);
+    while (pos + sizeof(PcieSlotI2cBusMappingReply) <= data.size())
+    {
+        std::uint8_t len = data[pos + 1];
+        records.emplace_back(
+            data[pos],
+            std::string(data.begin() + pos + 2, data.begin() + pos + 2 + len));
+        pos += sizeof(PcieSlotI2cBusMappingReply) + len;
+    }
+    EXPECT_EQ(data.size(), pos);
+    EXPECT_EQ(header.recordCount, records.size());
+    return {header, records};
+}
+
+Slots makeSlots(size_t count, size_t nameLength)
+{
+    Slots slots;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string name = std::format("SLOT{}", i);
+        name.resize(std::max(name.size(), nameLength), '_');
+        slots.emplace_back(i + 10, name);
+    }
+    return slots;
+}
+
+TEST(PcieI2cListCommandTest, RequestTooShort)
+{
+    std::vector<std::uint8_t> request = {};
+
+    HandlerMock hMock;
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              pcieSlotI2cBusMappingList(request, &hMock));
+}
+
+TEST(PcieI2cListCommandTest, FirstPageBuildsMap)
+{
+    std::vector<std::uint8_t> request = {0};
+    auto slots = makeSlots(3, 0);
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(9, slots)));
+
+    auto result = ValidateReply(pcieSlotI2cBusMappingList(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysPcieSlotI2cBusMappingList, result.first);
+    auto [header, records] = parseList(result.second);
+    EXPECT_EQ(0, header.more);
+    EXPECT_EQ(9, header.generation);
+    EXPECT_EQ(slots, records);
+}
+
+TEST(PcieI2cListCommandTest, EmptyMap)
+{
+    std::vector<std::uint8_t> request = {0};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(1, {})));
+
+    auto result = ValidateReply(pcieSlotI2cBusMappingList(request, &hMock));
+    auto [header, records] = parseList(result.second);
+    EXPECT_EQ(0, header.more);
+    EXPECT_TRUE(records.empty());
+}
+
+TEST(PcieI2cListCommandTest, PagesStayOnTheirSnapshot)
+{
+    // 2 + 20 bytes per record: two fit in each reply.
+    auto slots = makeSlots(5, 20);
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(3, slots)));
+    // Later pages ask for generation 3 even though a newer one exists.
+    EXPECT_CALL(hMock, getI2cPcieMapping(3))
+        .WillRepeatedly(Return(makeSnapshot(3, slots)));
+
+    Slots all;
+    std::vector<std::uint8_t> request = {0};
+    for (int page = 0; page < 3; ++page)
+    {
+        auto result =
+            ValidateReply(pcieSlotI2cBusMappingList(request, &hMock));
+        EXPECT_GE(static_cast<size_t>(MAX_IPMI_BUFFER),
+                  result.second.size() + 1);
+        auto [header, records] = parseList(result.second);
+        all.insert(all.end(), records.begin(), records.end());
+        EXPECT_EQ(page < 2, header.more);
+        EXPECT_EQ(3, header.generation);
+        request = {header.nextEntry, header.generation};
+    }
+    EXPECT_EQ(slots, all);
+}
+
+TEST(PcieI2cListCommandTest, LongNamesAreSkipped)
+{
+    std::vector<std::uint8_t> request = {0};
+    auto slots = makeSlots(3, 0);
+    std::get<1>(slots[1]) = std::string(MAX_IPMI_BUFFER, 'x');
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(1, slots)));
+
+    auto result = ValidateReply(pcieSlotI2cBusMappingList(request, &hMock));
+    auto [header, records] = parseList(result.second);
+    EXPECT_EQ(0, header.more);
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ(slots[0], records[0]);
+    EXPECT_EQ(slots[2], records[1]);
+}
+
+TEST(PcieI2cListCommandTest, EntryOutOfRange)
+{
+    std::vector<std::uint8_t> request = {3};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping()).Times(0);
+    EXPECT_CALL(hMock, getI2cPcieMapping(0))
+        .WillOnce(Return(makeSnapshot(1, makeSlots(3, 0))));
+
+    EXPECT_EQ(::ipmi::responseParmOutOfRange(),
+              pcieSlotI2cBusMappingList(request, &hMock));
+}
+
+TEST(PcieI2cListCommandTest, DroppedGeneration)
+{
+    std::vector<std::uint8_t> request = {2, 3};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getI2cPcieMapping(3)).WillOnce(Return(nullptr));
+
+    EXPECT_EQ(::ipmi::responseInvalidReservationId(),
+              pcieSlotI2cBusMappingList(request, &hMock));
+}
+
+TEST(PcieSlotSnapshotTest, Lookups)
+{
+    PcieSlotSnapshot snapshot(1, {{4, "PE0"}, {9, "PE1"}, {4, "PE2"},
+                                  {12, "PE1"}});
+
+    EXPECT_EQ(0u, snapshot.findName("PE0"));
+    EXPECT_EQ(1u, snapshot.findName("PE1"));
+    EXPECT_EQ(2u, snapshot.findName("PE2"));
+    EXPECT_EQ(std::nullopt, snapshot.findName("PE"));
+    EXPECT_EQ(0u, snapshot.findBus(4));
+    EXPECT_EQ(3u, snapshot.findBus(12));
+    EXPECT_EQ(std::nullopt, snapshot.findBus(5));
+}
+
+TEST(PcieSlotLookupCommandTest, ByNameRequestTooShort)
+{
+    HandlerMock hMock;
+    std::vector<std::uint8_t> request = {0};
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              pcieSlotByName(request, &hMock));
+
+    // The name is shorter than its length says.
+    request = {0, 4, 'P', 'E', '0'};
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              pcieSlotByName(request, &hMock));
+}
+
+TEST(PcieSlotLookupCommandTest, ByNameFound)
+{
+    std::vector<std::uint8_t> request = {0, 3, 'P', 'E', '1'};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(6, {{4, "PE0"}, {9, "PE1"}})));
+
+    auto result = ValidateReply(pcieSlotByName(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysPcieSlotByName, result.first);
+    EXPECT_EQ((std::vector<std::uint8_t>{6, 1, 9}), result.second);
+}
+
+TEST(PcieSlotLookupCommandTest, ByNameInCountedGeneration)
+{
+    std::vector<std::uint8_t> request = {2, 3, 'P', 'E', '0'};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping()).Times(0);
+    EXPECT_CALL(hMock, getI2cPcieMapping(2))
+        .WillOnce(Return(makeSnapshot(2, {{4, "PE0"}})));
+
+    auto result = ValidateReply(pcieSlotByName(request, &hMock));
+    EXPECT_EQ((std::vector<std::uint8_t>{2, 0, 4}), result.second);
+}
+
+TEST(PcieSlotLookupCommandTest, ByNameMissing)
+{
+    std::vector<std::uint8_t> request = {0, 3, 'P', 'E', '7'};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(6, {{4, "PE0"}})));
+
+    EXPECT_EQ(::ipmi::responseInvalidFieldRequest(),
+              pcieSlotByName(request, &hMock));
+}
+
+TEST(PcieSlotLookupCommandTest, ByNameDroppedGeneration)
+{
+    std::vector<std::uint8_t> request = {2, 3, 'P', 'E', '0'};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, getI2cPcieMapping(2)).WillOnce(Return(nullptr));
+
+    EXPECT_EQ(::ipmi::responseInvalidReservationId(),
+              pcieSlotByName(request, &hMock));
+}
+
+TEST(PcieSlotLookupCommandTest, ByBusFound)
+{
+    std::vector<std::uint8_t> request = {9};
+
+    HandlerMock hMock;
+    EXPECT_CALL(hMock, buildI2cPcieMapping())
+        .WillOnce(Return(makeSnapshot(6, {{4, "PE0"}, {9, "PE1"}})));
+
+    auto result = ValidateReply(pcieSlotByBus(request, &hMock));
+    EXPECT_EQ(SysOEMCommands::SysPcieSlotByBus, result.first);
+    EXPECT_EQ((std::vector<std::uint8_t>{6, 1, 3, 'P', 'E', '1'}),
+              result.second);
+}
+
+TEST(PcieSlotLookupCommandTest, ByBusMissing)
+{
+    HandlerMock hMock;
+    std::vector<std::uint8_t> request = {};
+    EXPECT_EQ(::ipmi::responseReqDataLenInvalid(),
+              pcieSlotByBus(request, &hMock));
+
+    request = {5, 6};
+    EXPECT_CALL(hMock, getI2cPcieMapping(6))
+        .WillOnce(Return(makeSnapshot(6, {{4, "PE0"}})));
+    EXPECT_EQ(::ipmi::responseInvalidFieldRequest(),
+              pcieSlotByBus(request, &hMock));
+}
+
+class BuildPcieMapTest : public stdplus::gtest::TestWithTmp
+{
+  public:
+    std::string devices = std::format("{}/devices", CaseTmpDir());
+    std::string deviceTree = std::format("{}/dt", CaseTmpDir());
+
+    BuildPcieMapTest()
+    {
+        std::filesystem::create_directories(devices);
+        std::filesystem::create_directories(deviceTree);
+    }
+
+    static void writeFile(const std::string& path, const std::string& data)
+    {
+        std::filesystem::create_directories(
+            std::filesystem::path(path).parent_path());
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << data;
+    }
+
+    void addSlot(const std::string& bus, const std::string& node,
+                 const std::string& label)
+    {
+        writeFile(std::format("{}/{}/of_node/pcie-slot", devices, bus), node);
+        writeFile(std::format("{}{}/label", deviceTree, node), label);
+    }
+
+    auto scan() const
+    {
+        auto map = buildPcieMap(devices, deviceTree);
+        std::sort(map.begin(), map.end());
+        return map;
+    }
+};
+
+TEST_F(BuildPcieMapTest, SlotsAreMapped)
+{
+    addSlot("i2c-3", "/pcie-slot@0", std::string("PE0\0", 4));
+    addSlot("i2c-12", "/ahb/pcie-slot@1", "PE1");
+    // Device tree strings end in a NUL and may be padded with whitespace.
+    addSlot("i2c-40", "/pcie-slot@2", "  PE2\n");
+    writeFile(std::format("{}/i2c-40/of_node/pcie-slot", devices),
+              std::string("/pcie-slot@2\0", 13));
+
+    std::vector<std::tuple<std::uint32_t, std::string>> expected = {
+        {3, "PE0"}, {12, "PE1"}, {40, "PE2"}};
+    EXPECT_EQ(expected, scan());
+}
+
+TEST_F(BuildPcieMapTest, OtherEntriesAreSkipped)
+{
+    addSlot("i2c-1", "/pcie-slot@0", "PE0");
+    // Not buses.
+    addSlot("1-0050", "/pcie-slot@1", "PE1");
+    addSlot("i2c-", "/pcie-slot@2", "PE2");
+    addSlot("i2c-4x", "/pcie-slot@3", "PE3");
+    // A bus with no slot, a slot with no label and a relative slot path.
+    std::filesystem::create_directories(std::format("{}/i2c-5", devices));
+    writeFile(std::format("{}/i2c-6/of_node/pcie-slot", devices), "/none");
+    writeFile(std::format("{}/i2c-7/of_node/pcie-slot", devices), "dt/x");
+
+    std::vector<std::tuple<std::uint32_t, std::string>> expected = {
+        {1, "PE0"}};
+    EXPECT_EQ(expected, scan());
+}
+
+TEST_F(BuildPcieMapTest, MissingDirectory)
+{
+    EXPECT_TRUE(buildPcieMap(std::format("{}/none", CaseTmpDir())).empty());
+}
+
 } // namespace ipmi
 } // namespace google
@@ -0,0 +1,109 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tracing.hpp"
+
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+namespace trace
+{
+namespace
+{
+
+std::vector<std::tuple<std::uint8_t, std::string>> fired;
+
+bool alwaysEnabled()
+{
+    return true;
+}
+
+void record(std::uint8_t cmd, const char* target, std::uint8_t, std::uint64_t)
+{
+    fired.emplace_back(cmd, target);
+}
+
+using TestProbe = OperationProbe<alwaysEnabled, record>;
+
+// A handler for cmd that waits for delay in the middle of an operation, as
+// the D-Bus calls and the BMC mode wait do, then starts another.
+void handler(boost::asio::io_context& io, std::uint8_t cmd,
+             std::chrono::milliseconds delay, const char* waiting,
+             const char* after)
+{
+    boost::asio::spawn(
+        io,
+        [&io, cmd, delay, waiting, after](boost::asio::yield_context yield) {
+            CommandProbe command(cmd, 0);
+            {
+                TestProbe probe(waiting);
+                boost::asio::steady_timer timer(io, delay);
+                boost::system::error_code ec;
+                SuspendScope suspend;
+                timer.async_wait(yield[ec]);
+            }
+            TestProbe probe(after);
+        },
+        boost::asio::detached);
+}
+
+} // namespace
+
+TEST(TracingTest, InterleavedCommandsKeepTheirOwnIds)
+{
+    fired.clear();
+    boost::asio::io_context io;
+
+    // 0x01 starts first but finishes last.
+    handler(io, 0x01, std::chrono::milliseconds(40), "a-wait", "a-after");
+    handler(io, 0x02, std::chrono::milliseconds(10), "b-wait", "b-after");
+    io.run();
+
+    std::vector<std::tuple<std::uint8_t, std::string>> expected = {
+        {0x02, "b-wait"},
+        {0x02, "b-after"},
+        {0x01, "a-wait"},
+        {0x01, "a-after"},
+    };
+    EXPECT_EQ(expected, fired);
+    EXPECT_EQ(noCommand, runningCommand);
+}
+
+TEST(TracingTest, OutsideCommandIsNoCommand)
+{
+    fired.clear();
+    {
+        TestProbe probe("idle");
+    }
+    ASSERT_EQ(1, fired.size());
+    EXPECT_EQ(noCommand, std::get<0>(fired[0]));
+}
+
+} // namespace trace
+} // namespace ipmi
+} // namespace google
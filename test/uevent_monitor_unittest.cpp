@@ -0,0 +1,58 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "uevent_monitor.hpp"
+
+#include <optional>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+using namespace std::string_view_literals;
+
+TEST(UeventSubsystemTest, FindsSubsystem)
+{
+    auto msg = "add@/devices/platform/ahb/1e78a000.i2c/i2c-12\0"
+               "ACTION=add\0"
+               "DEVPATH=/devices/platform/ahb/1e78a000.i2c/i2c-12\0"
+               "SUBSYSTEM=i2c\0"
+               "SEQNUM=1234\0"sv;
+    EXPECT_EQ("i2c", ueventSubsystem(msg));
+}
+
+TEST(UeventSubsystemTest, LastFieldWithoutTerminator)
+{
+    auto msg = "remove@/devices/virtual/net/tap0\0"
+               "ACTION=remove\0"
+               "SUBSYSTEM=net"sv;
+    EXPECT_EQ("net", ueventSubsystem(msg));
+}
+
+TEST(UeventSubsystemTest, NoSubsystem)
+{
+    EXPECT_EQ(std::nullopt, ueventSubsystem(""sv));
+    EXPECT_EQ(std::nullopt, ueventSubsystem("add@/devices/x"sv));
+    EXPECT_EQ(std::nullopt, ueventSubsystem("add@/devices/x\0"sv));
+    // The header is not a field, even if it looks like one.
+    EXPECT_EQ(std::nullopt,
+              ueventSubsystem("SUBSYSTEM=i2c\0ACTION=add\0"sv));
+}
+
+} // namespace ipmi
+} // namespace google
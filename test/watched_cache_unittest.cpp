@@ -0,0 +1,195 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "watched_cache.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdplus/gtest/tmp.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace google
+{
+namespace ipmi
+{
+
+class WatchedCacheTest : public stdplus::gtest::TestWithTmp
+{
+  public:
+    std::string dir = std::format("{}/dir", CaseTmpDir());
+    std::string filename = std::format("{}/watched", dir);
+    int loads = 0;
+
+    WatchedCacheTest()
+    {
+        ::mkdir(dir.c_str(), 0755);
+    }
+
+    static void writeFile(const std::string& path, const std::string& data)
+    {
+        std::ofstream ofs(path, std::ios::trunc);
+        ofs << data;
+    }
+
+    int get(WatchedCache<int>& cache)
+    {
+        return cache.get([this](int& value) { value = ++loads; });
+    }
+
+    // Changes are seen on the watcher thread; give it a few seconds.
+    int waitForLoad(WatchedCache<int>& cache, int expected)
+    {
+        int value = get(cache);
+        for (int i = 0; i < 500 && value < expected; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            value = get(cache);
+        }
+        return value;
+    }
+};
+
+TEST_F(WatchedCacheTest, KeptUntilChanged)
+{
+    std::atomic<int> changes = 0;
+    InotifyWatcher watcher;
+    WatchedCache<int> cache(watcher, {filename}, [&] { ++changes; });
+
+    EXPECT_EQ(1, get(cache));
+    EXPECT_TRUE(cache.watched());
+    EXPECT_EQ(1, get(cache));
+
+    writeFile(filename, "data");
+    EXPECT_EQ(2, waitForLoad(cache, 2));
+    EXPECT_EQ(2, get(cache));
+    EXPECT_EQ(1, changes);
+
+    cache.invalidate();
+    EXPECT_EQ(3, get(cache));
+    EXPECT_EQ(3, cache.last());
+}
+
+TEST_F(WatchedCacheTest, FailedLoadIsTriedAgain)
+{
+    // A load that fails marks the value stale, so the next call retries.
+    InotifyWatcher watcher;
+    WatchedCache<int> cache(watcher, {filename});
+    auto failing = [&](int& value) {
+        value = ++loads;
+        cache.invalidate();
+    };
+
+    EXPECT_EQ(1, cache.get(failing));
+    EXPECT_EQ(2, get(cache));
+    EXPECT_EQ(2, get(cache));
+}
+
+TEST_F(WatchedCacheTest, UnwatchedLoadsEveryTime)
+{
+    InotifyWatcher watcher;
+    WatchedCache<int> cache(watcher,
+                            {std::format("{}/none/file", CaseTmpDir())});
+
+    EXPECT_EQ(1, get(cache));
+    EXPECT_FALSE(cache.watched());
+    EXPECT_EQ(2, get(cache));
+}
+
+TEST_F(WatchedCacheTest, UnwatchedAddedAgainAfterDelay)
+{
+    std::string noneDir = std::format("{}/none", CaseTmpDir());
+    InotifyWatcher watcher;
+    WatchedCache<int> cache(watcher, {std::format("{}/file", noneDir)});
+    EXPECT_EQ(1, get(cache));
+    EXPECT_FALSE(cache.watched());
+
+    // Once the directory exists, the watch is added by a later call.
+    ASSERT_EQ(0, ::mkdir(noneDir.c_str(), 0755));
+    bool watched = cache.watched();
+    for (int i = 0; i < 500 && !watched; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        watched = cache.watched();
+    }
+    ASSERT_TRUE(watched);
+    int loaded = get(cache);
+    EXPECT_EQ(loaded, get(cache));
+}
+
+TEST_F(WatchedCacheTest, WatchedAgainWhenDropped)
+{
+    InotifyWatcher watcher;
+    WatchedCache<int> cache(watcher, {filename});
+    EXPECT_EQ(1, get(cache));
+
+    // Deleting the directory drops the watch; the value is loaded again and
+    // the watch added again once the directory is back.
+    ASSERT_EQ(0, ::rmdir(dir.c_str()));
+    ASSERT_EQ(0, ::mkdir(dir.c_str(), 0755));
+    EXPECT_EQ(2, waitForLoad(cache, 2));
+    EXPECT_TRUE(cache.watched());
+    EXPECT_EQ(2, get(cache));
+
+    writeFile(filename, "data");
+    EXPECT_EQ(3, waitForLoad(cache, 3));
+}
+
+TEST_F(WatchedCacheTest, OnlyDroppedWatchesAddedAgain)
+{
+    std::string otherDir = std::format("{}/other", CaseTmpDir());
+    std::string otherFile = std::format("{}/watched", otherDir);
+    ASSERT_EQ(0, ::mkdir(otherDir.c_str(), 0755));
+    // Created up front, so a write to it is a single event.
+    writeFile(otherFile, "");
+
+    std::atomic<int> changes = 0;
+    InotifyWatcher watcher;
+    WatchedCache<int> cache(watcher, {filename, otherFile},
+                            [&] { ++changes; });
+    EXPECT_EQ(1, get(cache));
+
+    ASSERT_EQ(0, ::rmdir(dir.c_str()));
+    ASSERT_EQ(0, ::mkdir(dir.c_str(), 0755));
+    EXPECT_EQ(2, waitForLoad(cache, 2));
+    EXPECT_TRUE(cache.watched());
+
+    // Events are handled in order, and the sentinel's watch is the last
+    // added, so once it fires every earlier callback has run.
+    std::string sentinel = std::format("{}/sentinel", CaseTmpDir());
+    std::atomic<bool> synced = false;
+    ASSERT_TRUE(watcher.watch(sentinel, [&] { synced = true; }));
+
+    // The other directory kept its watch, so a change to it is seen once.
+    int before = changes;
+    writeFile(otherFile, "data");
+    writeFile(sentinel, "");
+    for (int i = 0; i < 500 && !synced; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(synced);
+    EXPECT_EQ(before + 1, changes);
+}
+
+} // namespace ipmi
+} // namespace google
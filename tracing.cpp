@@ -0,0 +1,29 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tracing.hpp"
+
+#if HAVE_USDT
+extern "C"
+{
+__extension__ unsigned short googlesys_dispatch_entry_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+__extension__ unsigned short googlesys_dispatch_exit_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+__extension__ unsigned short googlesys_dbus_call_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+__extension__ unsigned short googlesys_file_read_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+}
+#endif
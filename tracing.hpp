@@ -0,0 +1,247 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "config.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <expected>
+#include <optional>
+
+#if HAVE_USDT
+// Semaphores let a probe site skip the clock reads entirely unless a tracer
+// is attached; bpftrace and systemtap bump them when they attach.
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+extern "C"
+{
+__extension__ extern unsigned short googlesys_dispatch_entry_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+__extension__ extern unsigned short googlesys_dispatch_exit_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+__extension__ extern unsigned short googlesys_dbus_call_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+__extension__ extern unsigned short googlesys_file_read_semaphore
+    __attribute__((unused)) __attribute__((section(".probes")));
+}
+
+#define GOOGLESYS_PROBE_ENABLED(name)                                          \
+    __builtin_expect(googlesys_##name##_semaphore, 0)
+#else
+#define GOOGLESYS_PROBE_ENABLED(name) false
+#endif
+
+namespace google
+{
+namespace ipmi
+{
+namespace trace
+{
+
+// Reported as the subcommand of an operation outside of any command.
+constexpr std::uint8_t noCommand = 0xff;
+
+// The subcommand whose handler is running on this thread right now. ipmid
+// runs handlers as coroutines on one thread, so this is not a stack: a
+// handler clears it with SuspendScope while it waits and sets it back when it
+// resumes, and the probes copy it when they are created.
+inline thread_local std::uint8_t runningCommand = noCommand;
+
+using Clock = std::chrono::steady_clock;
+
+inline std::uint64_t elapsedNs(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now() - start)
+        .count();
+}
+
+/**
+ * Fires googlesys:dispatch_entry on construction and googlesys:dispatch_exit
+ * on destruction.
+ *
+ * dispatch_entry(subcommand, payload size)
+ * dispatch_exit(subcommand, payload size, cc, duration ns)
+ */
+class CommandProbe
+{
+  public:
+    CommandProbe(std::uint8_t cmd, std::size_t size) : cmd(cmd), size(size)
+    {
+        runningCommand = cmd;
+#if HAVE_USDT
+        if (GOOGLESYS_PROBE_ENABLED(dispatch_entry))
+        {
+            STAP_PROBE2(googlesys, dispatch_entry, cmd, size);
+        }
+        if (GOOGLESYS_PROBE_ENABLED(dispatch_exit))
+        {
+            start = Clock::now();
+        }
+#endif
+    }
+
+    ~CommandProbe()
+    {
+#if HAVE_USDT
+        if (start)
+        {
+            std::uint8_t result = cc.value_or(0xff);
+            std::uint64_t ns = elapsedNs(*start);
+            STAP_PROBE4(googlesys, dispatch_exit, cmd, size, result, ns);
+        }
+#endif
+        runningCommand = noCommand;
+    }
+
+    CommandProbe(const CommandProbe&) = delete;
+    CommandProbe& operator=(const CommandProbe&) = delete;
+
+    void setCc(std::uint8_t value)
+    {
+        cc = value;
+    }
+
+  private:
+    std::uint8_t cmd;
+    std::size_t size;
+    std::optional<std::uint8_t> cc;
+    std::optional<Clock::time_point> start;
+};
+
+/**
+ * Marks the running handler as suspended for the life of the scope, around a
+ * yield that lets other handlers run, and marks it running again after.
+ */
+class SuspendScope
+{
+  public:
+    SuspendScope() : cmd(runningCommand)
+    {
+        runningCommand = noCommand;
+    }
+
+    ~SuspendScope()
+    {
+        runningCommand = cmd;
+    }
+
+    SuspendScope(const SuspendScope&) = delete;
+    SuspendScope& operator=(const SuspendScope&) = delete;
+
+  private:
+    std::uint8_t cmd;
+};
+
+/**
+ * Times one external operation and fires a probe carrying the subcommand that
+ * was running when it started, a description of the target, the cc and the
+ * duration.
+ *
+ * If no cc was set and the scope is left by an exception, the operation is
+ * reported as ccUnspecifiedError (0xff); fail() records the cc of an error
+ * returned by value.
+ */
+template <bool (*Enabled)(), void (*Fire)(std::uint8_t, const char*,
+                                          std::uint8_t, std::uint64_t)>
+class OperationProbe
+{
+  public:
+    explicit OperationProbe(const char* target) :
+        cmd(runningCommand), target(target),
+        exceptions(std::uncaught_exceptions())
+    {
+        if (Enabled())
+        {
+            start = Clock::now();
+        }
+    }
+
+    ~OperationProbe()
+    {
+        if (start)
+        {
+            std::uint8_t result =
+                cc.value_or(std::uncaught_exceptions() > exceptions ? 0xff : 0);
+            Fire(cmd, target, result, elapsedNs(*start));
+        }
+    }
+
+    OperationProbe(const OperationProbe&) = delete;
+    OperationProbe& operator=(const OperationProbe&) = delete;
+
+    void setCc(std::uint8_t value)
+    {
+        cc = value;
+    }
+
+    /** Record a failed operation and return the cc for the caller. */
+    std::unexpected<std::uint8_t> fail(std::uint8_t value)
+    {
+        cc = value;
+        return std::unexpected(value);
+    }
+
+  private:
+    std::uint8_t cmd;
+    const char* target;
+    int exceptions;
+    std::optional<std::uint8_t> cc;
+    std::optional<Clock::time_point> start;
+};
+
+inline bool dbusCallEnabled()
+{
+    return GOOGLESYS_PROBE_ENABLED(dbus_call);
+}
+
+inline void fireDbusCall([[maybe_unused]] std::uint8_t cmd,
+                         [[maybe_unused]] const char* method,
+                         [[maybe_unused]] std::uint8_t cc,
+                         [[maybe_unused]] std::uint64_t ns)
+{
+#if HAVE_USDT
+    STAP_PROBE4(googlesys, dbus_call, cmd, method, cc, ns);
+#endif
+}
+
+inline bool fileReadEnabled()
+{
+    return GOOGLESYS_PROBE_ENABLED(file_read);
+}
+
+inline void fireFileRead([[maybe_unused]] std::uint8_t cmd,
+                         [[maybe_unused]] const char* path,
+                         [[maybe_unused]] std::uint8_t cc,
+                         [[maybe_unused]] std::uint64_t ns)
+{
+#if HAVE_USDT
+    STAP_PROBE4(googlesys, file_read, cmd, path, cc, ns);
+#endif
+}
+
+// dbus_call(subcommand, method, cc, duration ns)
+using DbusCallProbe = OperationProbe<dbusCallEnabled, fireDbusCall>;
+
+// file_read(subcommand, path, cc, duration ns)
+using FileReadProbe = OperationProbe<fileReadEnabled, fireFileRead>;
+
+} // namespace trace
+} // namespace ipmi
+} // namespace google
@@ -0,0 +1,239 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "uevent_monitor.hpp"
+
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <stdplus/print.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+namespace
+{
+
+// Kernel uevents go to the first multicast group; udevd rebroadcasts on the
+// second in its own format.
+constexpr std::uint32_t kernelGroup = 1;
+
+} // namespace
+
+std::optional<std::string_view> ueventSubsystem(std::string_view message)
+{
+    constexpr std::string_view key = "SUBSYSTEM=";
+
+    // Skip the "action@devpath" header.
+    size_t pos = message.find('\0');
+    while (pos != std::string_view::npos && ++pos < message.size())
+    {
+        size_t end = message.find('\0', pos);
+        auto field = message.substr(pos, end - pos);
+        if (field.starts_with(key))
+        {
+            return field.substr(key.size());
+        }
+        pos = end;
+    }
+    return std::nullopt;
+}
+
+UeventMonitor::~UeventMonitor()
+{
+    if (thread.joinable())
+    {
+        std::uint64_t one = 1;
+        if (::write(stopFd.get(), &one, sizeof(one)) < 0)
+        {
+            stdplus::print(stderr, "Failed to stop uevent monitor: {}\n",
+                           std::strerror(errno));
+        }
+        thread.join();
+    }
+}
+
+bool UeventMonitor::start()
+{
+    if (netlinkFd.get() < 0)
+    {
+        ScopedFd fd(::socket(AF_NETLINK,
+                             SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                             NETLINK_KOBJECT_UEVENT));
+        if (fd.get() < 0)
+        {
+            stdplus::print(stderr, "uevent socket failed: {}\n",
+                           std::strerror(errno));
+            return false;
+        }
+
+        sockaddr_nl addr{};
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = kernelGroup;
+        if (::bind(fd.get(), reinterpret_cast<sockaddr*>(&addr),
+                   sizeof(addr)) < 0)
+        {
+            stdplus::print(stderr, "uevent bind failed: {}\n",
+                           std::strerror(errno));
+            return false;
+        }
+        netlinkFd = std::move(fd);
+    }
+    if (stopFd.get() < 0)
+    {
+        stopFd.reset(eventfd(0, EFD_CLOEXEC));
+        if (stopFd.get() < 0)
+        {
+            stdplus::print(stderr, "eventfd failed: {}\n",
+                           std::strerror(errno));
+            return false;
+        }
+    }
+    if (!thread.joinable())
+    {
+        thread = std::thread(&UeventMonitor::run, this);
+    }
+    return true;
+}
+
+bool UeventMonitor::watch(const std::string& subsystem, Callback callback)
+{
+    std::lock_guard guard(lock);
+    if (!start())
+    {
+        return false;
+    }
+
+    watches.push_back(Watch{subsystem, std::move(callback)});
+    return true;
+}
+
+void UeventMonitor::run()
+{
+    std::array<char, 8192> buf;
+    std::array<pollfd, 2> fds{
+        {{stopFd.get(), POLLIN, 0}, {netlinkFd.get(), POLLIN, 0}}};
+
+    while (true)
+    {
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            stdplus::print(stderr, "uevent monitor poll failed: {}\n",
+                           std::strerror(errno));
+            return;
+        }
+        if (fds[0].revents)
+        {
+            return;
+        }
+
+        // Gather the whole batch first, so a burst of events for one
+        // subsystem, as when a mux is probed, is only handled once.
+        std::vector<size_t> pending;
+        bool overflow = false;
+        while (true)
+        {
+            sockaddr_nl src{};
+            iovec iov{buf.data(), buf.size()};
+            msghdr msg{};
+            msg.msg_name = &src;
+            msg.msg_namelen = sizeof(src);
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+
+            ssize_t len = ::recvmsg(netlinkFd.get(), &msg, 0);
+            if (len < 0)
+            {
+                if (errno == ENOBUFS)
+                {
+                    overflow = true;
+                    continue;
+                }
+                break;
+            }
+            // Only trust the kernel, not other senders on the group.
+            if (src.nl_pid != 0)
+            {
+                continue;
+            }
+
+            auto subsystem = ueventSubsystem(std::string_view(buf.data(), len));
+            if (!subsystem)
+            {
+                continue;
+            }
+
+            std::lock_guard guard(lock);
+            for (size_t i = 0; i < watches.size(); ++i)
+            {
+                if (watches[i].subsystem == *subsystem &&
+                    std::find(pending.begin(), pending.end(), i) ==
+                        pending.end())
+                {
+                    pending.push_back(i);
+                }
+            }
+        }
+
+        // Callbacks run without the lock so they may add watches.
+        std::vector<Callback> callbacks;
+        {
+            std::lock_guard guard(lock);
+            if (overflow)
+            {
+                for (const auto& w : watches)
+                {
+                    callbacks.push_back(w.callback);
+                }
+            }
+            else
+            {
+                for (size_t i : pending)
+                {
+                    callbacks.push_back(watches[i].callback);
+                }
+            }
+        }
+        for (const auto& cb : callbacks)
+        {
+            cb();
+        }
+    }
+}
+
+} // namespace ipmi
+} // namespace google
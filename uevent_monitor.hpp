@@ -0,0 +1,87 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "scoped_fd.hpp"
+
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * Return the SUBSYSTEM of a kernel uevent message.
+ *
+ * @param[in] message - "action@devpath" followed by NUL separated KEY=value
+ *                      pairs, as read from a NETLINK_KOBJECT_UEVENT socket.
+ * @return the subsystem, or std::nullopt if the message has none.
+ */
+std::optional<std::string_view> ueventSubsystem(std::string_view message);
+
+/**
+ * Runs callbacks when the kernel reports a device event for a subsystem.
+ *
+ * Listens on a NETLINK_KOBJECT_UEVENT socket for events sent by the kernel
+ * itself. All subsystems share one socket and one thread, started by the first
+ * successful watch() and stopped by the destructor.
+ */
+class UeventMonitor
+{
+  public:
+    using Callback = std::function<void()>;
+
+    UeventMonitor() = default;
+    ~UeventMonitor();
+
+    UeventMonitor(const UeventMonitor&) = delete;
+    UeventMonitor& operator=(const UeventMonitor&) = delete;
+
+    /**
+     * Call callback, on the monitor thread, after any uevent for subsystem.
+     * If the kernel drops events, every callback is called.
+     *
+     * @param[in] subsystem - the subsystem to watch, e.g. "i2c".
+     * @param[in] callback - the function to call.
+     * @return true if the monitor is running.
+     */
+    bool watch(const std::string& subsystem, Callback callback);
+
+  private:
+    struct Watch
+    {
+        std::string subsystem;
+        Callback callback;
+    };
+
+    bool start();
+    void run();
+
+    std::mutex lock;
+    std::vector<Watch> watches;
+    ScopedFd netlinkFd;
+    ScopedFd stopFd;
+    std::thread thread;
+};
+
+} // namespace ipmi
+} // namespace google
@@ -14,17 +14,30 @@
 
 #include "util.hpp"
 
+#include "scoped_fd.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/elog-errors.hpp>
 #include <stdplus/print.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
 #include <cstdint>
 #include <cstdio>
-#include <filesystem>
+#include <cstring>
 #include <fstream>
-#include <regex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <tuple>
 #include <vector>
 
@@ -32,7 +45,6 @@ namespace google
 {
 namespace ipmi
 {
-namespace fs = std::filesystem;
 using namespace phosphor::logging;
 using InternalFailure =
     sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
@@ -89,57 +101,139 @@ std::string readPropertyFile(const std::string& fileName)
     return "";
 }
 
-std::vector<std::tuple<std::uint32_t, std::string>> buildPcieMap()
+namespace
 {
-    std::vector<std::tuple<std::uint32_t, std::string>> pcie_i2c_map;
 
-    // Build a vector with i2c bus to pcie slot mapping.
-    // Iterate through all the devices under "/sys/bus/i2c/devices".
-    for (const auto& i2c_dev : fs::directory_iterator("/sys/bus/i2c/devices"))
+// Return N for a directory entry named "i2c-N".
+std::optional<std::uint32_t> parseBusName(std::string_view name)
+{
+    constexpr std::string_view prefix = "i2c-";
+    if (!name.starts_with(prefix) || name.size() == prefix.size())
+    {
+        return std::nullopt;
+    }
+    name.remove_prefix(prefix.size());
+
+    std::uint32_t bus;
+    auto [end, ec] =
+        std::from_chars(name.data(), name.data() + name.size(), bus);
+    if (ec != std::errc() || end != name.data() + name.size())
+    {
+        return std::nullopt;
+    }
+    return bus;
+}
+
+// Read a property relative to dirFd into buf, and return the same token
+// readPropertyFile() would: the first whitespace separated word, less one
+// trailing NUL. Returns an empty view if the property is missing or too long.
+std::string_view readProperty(int dirFd, const char* path, std::span<char> buf)
+{
+    ScopedFd fd(::openat(dirFd, path, O_RDONLY | O_CLOEXEC));
+    if (fd.get() < 0)
+    {
+        return {};
+    }
+    ssize_t len = ::read(fd.get(), buf.data(), buf.size());
+    if (len <= 0 || static_cast<size_t>(len) == buf.size())
+    {
+        return {};
+    }
+
+    constexpr std::string_view whitespace = " \t\n\v\f\r";
+    std::string_view contents(buf.data(), len);
+    size_t begin = contents.find_first_not_of(whitespace);
+    if (begin == std::string_view::npos)
+    {
+        return {};
+    }
+    contents.remove_prefix(begin);
+    contents = contents.substr(0, contents.find_first_of(whitespace));
+    if (contents.ends_with('\0'))
+    {
+        contents.remove_suffix(1);
+    }
+    return contents;
+}
+
+// Join the parts into buf as a NUL terminated path; false if it won't fit.
+bool joinPath(std::span<char> buf, std::string_view a, std::string_view b)
+{
+    if (a.size() + b.size() >= buf.size())
     {
-        std::string i2c_dev_path = i2c_dev.path();
-        std::smatch i2c_dev_string_number;
-        std::regex e("(i2c-)(\\d+)");
+        return false;
+    }
+    auto end = std::copy(a.begin(), a.end(), buf.begin());
+    end = std::copy(b.begin(), b.end(), end);
+    *end = '\0';
+    return true;
+}
+
+} // namespace
+
+std::vector<std::tuple<std::uint32_t, std::string>> buildPcieMap(
+    const std::string& i2cDevicesDir, const std::string& deviceTreeDir)
+{
+    std::vector<std::tuple<std::uint32_t, std::string>> pcie_i2c_map;
 
-        // Check if the device has "i2c-" in its path.
-        if (std::regex_search(i2c_dev_path, i2c_dev_string_number, e))
+    // Everything is opened relative to these two directories, so a bus
+    // without a slot costs one failed openat() and nothing else.
+    ScopedFd devicesFd(::open(i2cDevicesDir.c_str(),
+                              O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (devicesFd.get() < 0)
+    {
+        stdplus::print(stderr, "Unable to open {}: {}\n", i2cDevicesDir,
+                       std::strerror(errno));
+        return pcie_i2c_map;
+    }
+    ScopedFd deviceTreeFd(::open(deviceTreeDir.c_str(),
+                                 O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+
+    alignas(dirent64) std::array<char, 8192> dents;
+    std::array<char, 64> busPath;
+    std::array<char, 256> slot;
+    std::array<char, 320> labelPath;
+    std::array<char, 256> label;
+
+    ssize_t len;
+    while ((len = ::getdents64(devicesFd.get(), dents.data(), dents.size())) >
+           0)
+    {
+        for (ssize_t pos = 0; pos < len;)
         {
-            // Check if the i2c device has "pcie-slot" file under "of-node" dir.
-            std::string pcie_slot_path = i2c_dev_path + "/of_node/pcie-slot";
-            std::string pcie_slot;
+            const auto* dent = reinterpret_cast<const dirent64*>(&dents[pos]);
+            pos += dent->d_reclen;
 
-            // Read the "pcie-slot" name from the "pcie-slot" file.
-            pcie_slot = readPropertyFile(pcie_slot_path);
-            if (pcie_slot.empty())
+            std::string_view name(dent->d_name);
+            auto bus = parseBusName(name);
+            if (!bus || !joinPath(busPath, name, "/of_node/pcie-slot"))
             {
                 continue;
             }
-            std::string pcie_slot_name;
-            std::string pcie_slot_full_path;
-
-            // Append the "pcie-slot" name to dts base.
-            pcie_slot_full_path.append("/proc/device-tree");
-            pcie_slot_full_path.append(pcie_slot);
-
-            // Read the "label" which contains the pcie slot name.
-            pcie_slot_full_path.append("/label");
-            pcie_slot_name = readPropertyFile(pcie_slot_full_path);
 
-            if (pcie_slot_name.empty())
+            // The "pcie-slot" property holds the absolute device tree path of
+            // the slot, whose "label" is the slot name.
+            auto slotNode = readProperty(devicesFd.get(), busPath.data(), slot);
+            if (!slotNode.starts_with('/') ||
+                !joinPath(labelPath, slotNode.substr(1), "/label"))
+            {
+                continue;
+            }
+            auto slotName =
+                readProperty(deviceTreeFd.get(), labelPath.data(), label);
+            if (slotName.empty())
             {
                 continue;
             }
 
-            // Get the i2c bus number from the i2c device path.
-            std::uint32_t i2c_bus_number =
-                i2c_dev_string_number[2].matched
-                    ? std::stoi(i2c_dev_string_number[2])
-                    : 0;
-            // Store the i2c bus number and the pcie slot name in the vector.
-            pcie_i2c_map.push_back(
-                std::make_tuple(i2c_bus_number, pcie_slot_name));
+            pcie_i2c_map.emplace_back(*bus, std::string(slotName));
         }
     }
+    if (len < 0)
+    {
+        stdplus::print(stderr, "Unable to read {}: {}\n", i2cDevicesDir,
+                       std::strerror(errno));
+    }
 
     return pcie_i2c_map;
 }
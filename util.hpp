@@ -46,9 +46,13 @@ std::string readPropertyFile(const std::string& fileName);
 /**
  * Build a map of the i2c bus numbers to their PCIe slot names.
  *
+ * @param[in] i2cDevicesDir - the directory holding the i2c-N bus entries.
+ * @param[in] deviceTreeDir - the device tree root the slot paths are under.
  * @return list of pairs of i2c bus with their corresponding slot names.
  */
-std::vector<std::tuple<std::uint32_t, std::string>> buildPcieMap();
+std::vector<std::tuple<std::uint32_t, std::string>> buildPcieMap(
+    const std::string& i2cDevicesDir = "/sys/bus/i2c/devices",
+    const std::string& deviceTreeDir = "/proc/device-tree");
 
 } // namespace ipmi
 } // namespace google
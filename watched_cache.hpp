@@ -0,0 +1,206 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "inotify_watcher.hpp"
+#include "uevent_monitor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace google
+{
+namespace ipmi
+{
+
+/**
+ * A value worked out from files or devices, kept until a watch reports that
+ * they changed.
+ *
+ * The watches are added by the first call. If they cannot be, the value is
+ * worked out again on every call, and adding them is tried again after a
+ * delay that doubles, up to a minute, each time it fails. If the watcher
+ * drops one, as when its directory is deleted, the value is worked out again
+ * and that watch is added again by the next call.
+ */
+template <typename T>
+class WatchedCache
+{
+  public:
+    using Callback = std::function<void()>;
+
+    /**
+     * @param[in] watcher - the watcher to add the watches to.
+     * @param[in] paths - the files to watch, as InotifyWatcher::watch().
+     * @param[in] changed - also called, on the watcher thread, on a change.
+     */
+    WatchedCache(InotifyWatcher& watcher, std::vector<std::string> paths,
+                 Callback changed = nullptr) :
+        WatchedCache(
+            watcher, [paths = std::move(paths)]() { return paths; },
+            std::move(changed))
+    {}
+
+    /**
+     * As above, but the files to watch are asked for each time the watches
+     * are added rather than given up front.
+     */
+    WatchedCache(InotifyWatcher& watcher,
+                 std::function<std::vector<std::string>()> paths,
+                 Callback changed = nullptr) :
+        keys(std::move(paths)),
+        watchOne([&watcher](const std::string& path, const Callback& changed,
+                            const Callback& lost) {
+            return watcher.watch(path, changed, lost);
+        }),
+        onChange(std::move(changed))
+    {}
+
+    /**
+     * @param[in] monitor - the monitor to add the watch to.
+     * @param[in] subsystem - the subsystem whose uevents are changes.
+     */
+    WatchedCache(UeventMonitor& monitor, std::string subsystem) :
+        keys([subsystem = std::move(subsystem)]() {
+            return std::vector<std::string>{subsystem};
+        }),
+        watchOne([&monitor](const std::string& subsystem,
+                            const Callback& changed, const Callback&) {
+            return monitor.watch(subsystem, changed);
+        })
+    {}
+
+    WatchedCache(const WatchedCache&) = delete;
+    WatchedCache& operator=(const WatchedCache&) = delete;
+
+    /**
+     * Add the watches that are not in place; true if they all are. Only the
+     * watches that were dropped or could not be added are added again, so
+     * the others are not doubled.
+     */
+    bool watched()
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (!tried || dropped.exchange(false) || (!armed && now >= retryAt))
+        {
+            tried = true;
+            armed = true;
+            // Held while adding, so a watch dropped meanwhile is not then
+            // recorded as in place.
+            std::lock_guard guard(activeLock);
+            for (const auto& key : keys())
+            {
+                if (active.contains(key))
+                {
+                    continue;
+                }
+                if (!watchOne(key, [this]() { changed(); },
+                              [this, key]() { lost(key); }))
+                {
+                    armed = false;
+                    continue;
+                }
+                active.insert(key);
+            }
+            if (armed)
+            {
+                // Nothing was seen before the watches were in place.
+                retryDelay = firstRetryDelay;
+                stale = true;
+            }
+            else
+            {
+                retryAt = now + retryDelay;
+                retryDelay = std::min(retryDelay * 2, maxRetryDelay);
+            }
+        }
+        return armed;
+    }
+
+    /** Work the value out again on the next call. */
+    void invalidate()
+    {
+        stale = true;
+    }
+
+    /**
+     * Return the value, first calling load with it to bring it up to date if
+     * it may have changed.
+     */
+    template <typename Load>
+    const T& get(Load&& load)
+    {
+        if (!watched() || stale.exchange(false))
+        {
+            load(value);
+        }
+        return value;
+    }
+
+    /** The value as of the last get(), as it was left. */
+    const T& last() const
+    {
+        return value;
+    }
+
+  private:
+    static constexpr std::chrono::seconds firstRetryDelay{1};
+    static constexpr std::chrono::seconds maxRetryDelay{60};
+
+    void changed()
+    {
+        stale = true;
+        if (onChange)
+        {
+            onChange();
+        }
+    }
+
+    void lost(const std::string& key)
+    {
+        {
+            std::lock_guard guard(activeLock);
+            active.erase(key);
+        }
+        stale = true;
+        dropped = true;
+    }
+
+    std::function<std::vector<std::string>()> keys;
+    std::function<bool(const std::string&, const Callback&, const Callback&)>
+        watchOne;
+    Callback onChange;
+    // The keys whose watch is in place; dropped on the watcher thread.
+    std::mutex activeLock;
+    std::unordered_set<std::string> active;
+    bool tried = false;
+    bool armed = false;
+    std::chrono::steady_clock::time_point retryAt;
+    std::chrono::seconds retryDelay = firstRetryDelay;
+    // Set on the watcher thread.
+    std::atomic<bool> stale = true;
+    std::atomic<bool> dropped = false;
+    T value{};
+};
+
+} // namespace ipmi
+} // namespace google